@@ -0,0 +1,104 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "board.h"
+#include "critical.h"
+
+//
+// Global variables.
+//
+
+#if ENABLE_CRITICAL_PROFILING
+volatile critical_profile g_critical_profiles[CriticalSectionCount];
+#endif
+
+#if ENABLE_OVERRUN_DETECTION
+volatile uint16_t g_late_sample_count;
+volatile uint16_t g_missed_sample_count;
+#endif
+
+#if ENABLE_CRITICAL_PROFILING
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+critical_entry EnterCriticalSection(uint8_t section)
+{
+    critical_entry entry;
+    
+    entry.sreg = SREG;
+    cli();
+    
+    entry.section = section;
+    entry.start_count = PWM_TIMER_COUNT;
+    entry.was_overflow_pending = (PWM_TIMER_OVERFLOW_PENDING() != 0);
+    
+    return entry;
+}
+
+void LeaveCriticalSection(critical_entry *entry)
+{
+    volatile critical_profile *profile = &g_critical_profiles[entry->section];
+    uint16_t end_count = PWM_TIMER_COUNT;
+    uint8_t is_overflow_pending = (PWM_TIMER_OVERFLOW_PENDING() != 0);
+    uint16_t cycles;
+    
+    //
+    // The timer count gives the cycles spent modulo one PWM period. With
+    // interrupts disabled nothing clears the overflow flag, so a flag that
+    // came up during the section, with the count not having wrapped back
+    // past its starting point, means a whole period on top.
+    //
+    // Note: This is exact up to two PWM periods and a lower bound beyond
+    //       that, which is plenty for spotting the sections that are too
+    //       long. A section that starts with the overflow already pending
+    //       (the PWM interrupt is late before we even begin) can only be
+    //       measured modulo one period. The call overhead of the profiling
+    //       itself, a few dozen cycles, is included in the measurement.
+    //
+    
+    cycles = (end_count - entry->start_count) & (CRITICAL_PWM_PERIOD - 1);
+    
+    if (is_overflow_pending && !entry->was_overflow_pending && (end_count >= entry->start_count))
+    {
+        cycles += CRITICAL_PWM_PERIOD;
+    }
+    
+    if (cycles > profile->worst_cycles)
+    {
+        profile->worst_cycles = cycles;
+    }
+    
+    if ((cycles >= CRITICAL_PWM_PERIOD) && (profile->long_count < 0xff))
+    {
+        profile->long_count++;
+    }
+    
+    SREG = entry->sreg;
+}
+
+#endif // ENABLE_CRITICAL_PROFILING
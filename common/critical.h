@@ -0,0 +1,162 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __CRITICAL_H__
+#define __CRITICAL_H__
+
+#include <util/atomic.h>
+
+#include "board.h"
+#include "trace.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Critical section profiling. Off unless turned on from the Makefile, which
+// the debug build profile does (see profiles.mk).
+//
+// With profiling on, every PROFILED_ATOMIC_BLOCK() records the longest time
+// it has kept interrupts disabled, in CPU cycles, and counts how many times
+// it has kept them disabled for a full PWM period or more; i.e. long enough
+// to make the PWM interrupt miss an output sample. The results are kept in
+// g_critical_profiles[], to be read with a debugger or from the simulator.
+// With profiling off, PROFILED_ATOMIC_BLOCK() is a plain ATOMIC_BLOCK().
+//
+
+#ifndef ENABLE_CRITICAL_PROFILING
+#define ENABLE_CRITICAL_PROFILING       0
+#endif
+
+//
+// The PWM timer runs without a prescaler, so it counts CPU cycles, and its
+// overflow marks one PWM period. Each board.h points PWM_TIMER_COUNT and
+// PWM_TIMER_OVERFLOW_PENDING() at its PWM timer, and sets the period if it
+// isn't the usual 8 bits (a power of two either way).
+//
+
+#ifndef CRITICAL_PWM_PERIOD
+#define CRITICAL_PWM_PERIOD             256
+#endif
+
+//
+// PWM interrupt overrun detection. Off unless turned on from the Makefile,
+// which the debug build profile does, or telemetry or the trace is on (see
+// telemetry.h and trace.h) to report them.
+//
+// The PWM interrupt handler calls PWM_INTERRUPT_ENTERED() first thing and
+// PWM_INTERRUPT_LEAVING() last thing. A timer count past PWM_LATE_THRESHOLD
+// on the way in means the interrupt was held up (by another interrupt or a
+// critical section) and the sample went out late. An overflow already pending
+// on the way out means the handler itself ran for more than a PWM period;
+// one more of those before the next one is serviced and a sample is lost for
+// good, and the LFO runs slow. Both counts saturate at 0xffff.
+//
+// Note: The late threshold includes the handler prologue (saving
+//       registers), which is longer in the speed profile where everything
+//       is inlined into the handler.
+//
+
+#ifndef ENABLE_OVERRUN_DETECTION
+#if ENABLE_TELEMETRY || ENABLE_TRACE
+#define ENABLE_OVERRUN_DETECTION        1
+#else
+#define ENABLE_OVERRUN_DETECTION        0
+#endif
+#endif
+
+#ifndef PWM_LATE_THRESHOLD
+#define PWM_LATE_THRESHOLD              128
+#endif
+
+#if ENABLE_OVERRUN_DETECTION
+#define PWM_INTERRUPT_ENTERED() \
+    do { if ((PWM_TIMER_COUNT >= PWM_LATE_THRESHOLD) && (g_late_sample_count != 0xffff)) g_late_sample_count++; } while (0)
+#define PWM_INTERRUPT_LEAVING() \
+    do { if (PWM_TIMER_OVERFLOW_PENDING() && (g_missed_sample_count != 0xffff)) { g_missed_sample_count++; TRACE(TraceEventOverrun, g_missed_sample_count); } } while (0)
+#else
+#define PWM_INTERRUPT_ENTERED()
+#define PWM_INTERRUPT_LEAVING()
+#endif
+
+//
+// The critical sections that are profiled, one entry each.
+//
+
+typedef enum
+{
+    CriticalSectionTap = 0,         // Manual tap handling in the main loop.
+    CriticalSectionSelection,       // Selection mode change (attiny84a).
+    CriticalSectionSettings,        // Settings snapshots (persistence etc.).
+    CriticalSectionQueue,           // Queued settings hand-over.
+    CriticalSectionPowerDown,       // Tempo count timeout before standby.
+    CriticalSectionCount            // Dummy entry to get the enum count.
+} CriticalSection;
+
+#if ENABLE_CRITICAL_PROFILING
+typedef struct
+{
+    uint16_t worst_cycles;
+    uint8_t long_count;             // Saturates at 0xff.
+} critical_profile;
+
+typedef struct
+{
+    uint8_t sreg;
+    uint8_t section;
+    uint16_t start_count;
+    uint8_t was_overflow_pending;
+} critical_entry;
+
+//
+// Same construct as ATOMIC_BLOCK(ATOMIC_RESTORESTATE); the cleanup attribute
+// makes sure the section is measured and the interrupt flag restored however
+// the block is left.
+//
+
+#define PROFILED_ATOMIC_BLOCK(section) \
+    for (critical_entry critical_entry_ __attribute__((__cleanup__(LeaveCriticalSection))) = EnterCriticalSection(section), \
+         *critical_todo_ = &critical_entry_; critical_todo_ != 0; critical_todo_ = 0)
+
+extern volatile critical_profile g_critical_profiles[CriticalSectionCount];
+#else
+#define PROFILED_ATOMIC_BLOCK(section)  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+
+#if ENABLE_OVERRUN_DETECTION
+extern volatile uint16_t g_late_sample_count;
+extern volatile uint16_t g_missed_sample_count;
+#endif
+
+//
+// Public function prototypes.
+//
+
+#if ENABLE_CRITICAL_PROFILING
+critical_entry EnterCriticalSection(uint8_t section);
+void LeaveCriticalSection(critical_entry *entry);
+#endif
+
+#endif // __CRITICAL_H__
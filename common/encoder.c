@@ -0,0 +1,90 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Note: Rotary encoder decoding based on artivle at:
+//       https://www.circuitsathome.com/mcu/rotary-encoder-interrupt-service-routine-for-avr-micros
+//
+
+#include <avr/io.h>
+
+#include "board.h"
+#include "encoder.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Accumulated table steps per detent, i.e. a full quadrature cycle.
+//
+
+#define ENCODER_STEPS_PER_DETENT        4
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+int8_t DecodeEncoder(uint8_t pins)
+{
+    static const int8_t encoder_table[16] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+    static uint8_t encoder_samples = 3;
+    static int8_t encoder_value = 0;
+    
+    //
+    // Keep sampling the four latest rotary states, as pairs of bits, in a
+    // shift register. Make room for the next sample (and discard the oldest
+    // one).
+    //
+    
+    encoder_samples <<= 2;
+    
+    //
+    // Since the current rotary samples need to be added to the shift
+    // register at the start, and they do not necessarily align pin-wise, they
+    // must be adjusted accordingly.
+    //
+    
+    encoder_samples |= ((pins & (1 << ROTARY_A_IN)) >> ROTARY_A_IN) | ((pins & (1 << ROTARY_B_IN)) >> (ROTARY_B_IN - 1));
+    
+    //
+    // Update the encoder value and check the result; only a full detent
+    // counts as a step.
+    //
+    
+    encoder_value += encoder_table[(encoder_samples & 0x0f)];
+    if (encoder_value >= ENCODER_STEPS_PER_DETENT)
+    {
+        encoder_value = 0;
+        
+        return 1;
+    }
+    else if (encoder_value <= -ENCODER_STEPS_PER_DETENT)
+    {
+        encoder_value = 0;
+        
+        return -1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,304 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Note: The settings are kept in a ring of EEPROM records, each with a
+//       sequence number and a checksum. A commit always goes to the slot
+//       following the newest one, so the EEPROM wear is spread evenly across
+//       the ring, and a commit that gets cut short (power loss, reset) only
+//       ever damages the record being written; the previous one is still
+//       there to fall back on.
+//
+//       Writing a byte to EEPROM takes ~3.4ms, which is far too long to wait
+//       around for in the main loop. Instead the record is written one byte
+//       at a time from the EEPROM ready interrupt.
+//
+
+#include <stddef.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>
+
+#include "board.h"
+#include "signaling.h"
+#include "critical.h"
+#include "persistence.h"
+
+//
+// Defines and structs.
+//
+
+#define RECORD_CHECKSUM_SEED            0x5a
+
+typedef struct
+{
+    uint8_t sequence;
+    lfo_settings settings;
+    uint8_t checksum;
+} persistence_record;
+
+//
+// Local function prototypes.
+//
+
+uint8_t CalculateRecordChecksum(const persistence_record *record);
+void CommitSettings();
+
+//
+// Global variables.
+//
+
+persistence_record g_eeprom_records[PERSISTENCE_SLOT_COUNT] EEMEM;
+
+//
+// The record last committed (or being committed), and which slot it went to.
+//
+
+volatile persistence_record g_stored_record;
+volatile uint8_t g_stored_slot;
+
+//
+// The settings as of the previous UpdatePersistence(), and for how long
+// they've stayed that way.
+//
+
+lfo_settings g_pending_settings;
+uint16_t g_pending_ms_count;
+
+//
+// Progress of the record write in progress. Equal to the record size when
+// there's nothing (left) to write.
+//
+
+volatile uint8_t g_write_index = sizeof(persistence_record);
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializePersistence()
+{
+    uint8_t slot;
+    uint8_t has_stored_record = 0;
+    persistence_record record;
+    
+    //
+    // Find the newest valid record, going by the sequence numbers. These wrap
+    // around, but with all records within PERSISTENCE_SLOT_COUNT of each
+    // other the 8-bit difference still tells which one is newer.
+    //
+    
+    for (slot = 0; slot < PERSISTENCE_SLOT_COUNT; slot++)
+    {
+        eeprom_read_block(&record, &g_eeprom_records[slot], sizeof(persistence_record));
+        
+        if (record.checksum != CalculateRecordChecksum(&record))
+        {
+            continue;
+        }
+        
+        if ((has_stored_record == 0) || ((int8_t)(record.sequence - g_stored_record.sequence) > 0))
+        {
+            memcpy((void *)&g_stored_record, &record, sizeof(persistence_record));
+            g_stored_slot = slot;
+            has_stored_record = 1;
+        }
+    }
+    
+    if (has_stored_record == 1)
+    {
+        ApplySettings((const lfo_settings *)&g_stored_record.settings);
+    }
+    else
+    {
+        //
+        // Nothing stored yet (or nothing intact). Make it look like the slot
+        // before the first one was last written, with whatever settings are
+        // current, so the first commit ends up in slot 0 and only happens
+        // once something has actually changed.
+        //
+        
+        GetSettings((lfo_settings *)&g_stored_record.settings);
+        g_stored_record.sequence = 0;
+        g_stored_slot = PERSISTENCE_SLOT_COUNT - 1;
+    }
+    
+    GetSettings(&g_pending_settings);
+    g_pending_ms_count = 0;
+}
+
+void UpdatePersistence()
+{
+    lfo_settings settings;
+    
+    //
+    // Called once per 1ms tick from the main loop. Any change to the
+    // settings restarts the count, so a commit only happens once things have
+    // settled down; e.g. not for every single notch of a potentiometer or
+    // encoder being turned.
+    //
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        GetSettings(&settings);
+    }
+    
+    if (memcmp(&settings, &g_pending_settings, sizeof(lfo_settings)) != 0)
+    {
+        memcpy(&g_pending_settings, &settings, sizeof(lfo_settings));
+        g_pending_ms_count = 0;
+        
+        return;
+    }
+    
+    if (g_pending_ms_count < PERSISTENCE_COMMIT_TIME)
+    {
+        g_pending_ms_count++;
+        
+        return;
+    }
+    
+    CommitSettings();
+}
+
+void FlushPersistence()
+{
+    //
+    // Commit any pending change right away and wait for the write to finish.
+    // Used before powering down, where the EEPROM ready interrupt can't wake
+    // us up to carry on writing.
+    //
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        GetSettings(&g_pending_settings);
+    }
+    
+    CommitSettings();
+    
+    WaitForPersistence();
+}
+
+void WaitForPersistence()
+{
+    //
+    // Wait for a write in progress, if any, to finish, without starting
+    // another. Nothing else may touch the EEPROM until then; the EEPROM ready
+    // interrupt would move the address out from under it. A new write only
+    // ever starts from the main loop, so the EEPROM stays ours until the
+    // next UpdatePersistence().
+    //
+    // The write index reaches the end as soon as the last byte (the checksum)
+    // is handed over, while it's still being programmed. It's the EEPROM
+    // ready interrupt finding nothing more to write, and turning itself off,
+    // that tells us the record is all there.
+    //
+    
+    while ((g_write_index < sizeof(persistence_record)) ||
+           (EECR & ((1 << EERIE) | (1 << EEPE))))
+    {
+    }
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+uint8_t CalculateRecordChecksum(const persistence_record *record)
+{
+    uint8_t count;
+    uint8_t checksum = RECORD_CHECKSUM_SEED;
+    const uint8_t *data = (const uint8_t *)record;
+    
+    //
+    // Everything but the checksum itself. An erased (all 0xff) record never
+    // comes out as valid.
+    //
+    
+    for (count = 0; count < offsetof(persistence_record, checksum); count++)
+    {
+        checksum = ((checksum << 1) | (checksum >> 7)) + data[count];
+    }
+    
+    return checksum;
+}
+
+void CommitSettings()
+{
+    //
+    // Start writing the pending settings to the next slot, unless they're
+    // already what was last stored, or a write is still in progress (in
+    // which case we'll be back on the next tick).
+    //
+    
+    if (g_write_index < sizeof(persistence_record))
+    {
+        return;
+    }
+    
+    if (memcmp(&g_pending_settings, (const void *)&g_stored_record.settings, sizeof(lfo_settings)) == 0)
+    {
+        return;
+    }
+    
+    memcpy((void *)&g_stored_record.settings, &g_pending_settings, sizeof(lfo_settings));
+    g_stored_record.sequence++;
+    g_stored_record.checksum = CalculateRecordChecksum((const persistence_record *)&g_stored_record);
+    
+    g_stored_slot++;
+    
+    if (g_stored_slot >= PERSISTENCE_SLOT_COUNT)
+    {
+        g_stored_slot = 0;
+    }
+    
+    g_write_index = 0;
+    
+    EECR |= (1 << EERIE);
+}
+
+//
+// EEPROM ready interrupt handler. Writes the next byte of the record being
+// committed. Fires whenever EEPROM is ready (i.e. repeatedly), as long as
+// it's enabled, so it disables itself once the whole record is written.
+//
+// Note: The checksum is the last byte of the record, so the record doesn't
+//       become valid until every other byte is in place.
+//
+
+ISR(EE_RDY_vect)
+{
+    if (g_write_index < sizeof(persistence_record))
+    {
+        EEAR = (uint16_t)&g_eeprom_records[g_stored_slot] + g_write_index;
+        EEDR = ((volatile uint8_t *)&g_stored_record)[g_write_index];
+        EECR |= (1 << EEMPE);
+        EECR |= (1 << EEPE);
+        
+        g_write_index++;
+    }
+    else
+    {
+        EECR &= ~(1 << EERIE);
+    }
+}
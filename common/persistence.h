@@ -1,5 +1,5 @@
 //
-// Tap-tempo LFO for 8-bit AVR.
+// Tap-tempo LFO and clock for 8-bit AVR.
 // 
 // Copyright (C) 2013-2016 Harald Sabro
 // 
@@ -22,40 +22,34 @@
 // Email: harald (AT) website 
 //
 
-#ifndef __SIGNALING_H__
-#define __SIGNALING_H__
+#ifndef __PERSISTENCE_H__
+#define __PERSISTENCE_H__
 
 //
 // Defines and structs.
 //
 
 //
-// In milliseconds = 0.1Hz, 10 seconds
+// Number of record slots in the EEPROM ring. Every commit goes to the next
+// slot, so each one only sees 1/PERSISTENCE_SLOT_COUNT of the writes.
 //
 
-#define LFO_MIN_TEMPO           		10000
+#define PERSISTENCE_SLOT_COUNT          16
 
 //
-// In milliseconds = 20Hz, 5/100ths of a second
+// In milliseconds. How long the settings have to stay unchanged before being
+// committed to EEPROM.
 //
 
-#define LFO_MAX_TEMPO           		50
+#define PERSISTENCE_COMMIT_TIME         5000
 
 //
 // Public function prototypes.
 //
 
-void SetBaseTempo(uint16_t milliseconds);
-void StartTempoCount();
-void StopTempoCount();
-void TempoCountTimeout();
-void ResetSignals();
+void InitializePersistence();
+void UpdatePersistence();
+void FlushPersistence();
+void WaitForPersistence();
 
-void SeedRandomNumberGenerator(uint32_t seed);
-void UpdateRandomNumber();
-void PlotWaveform();
-void AlignWaveform();
-void SetWaveform(uint8_t value);
-void SetMultiplier(uint8_t value);
-
-#endif // __SIGNALING_H__
+#endif // __PERSISTENCE_H__
@@ -0,0 +1,58 @@
+#
+# Build profiles, shared by the firmware Makefiles. Pick one with e.g.
+# "make PROFILE=speed", and "make clean" when switching between them since the
+# object files don't record which profile built them.
+#
+# PROFILE=size (default) -> -Os, for the smallest firmware.
+# PROFILE=speed          -> -O2, with everything the PWM interrupt calls
+#                           inlined into it (see ISR_FLATTEN in signaling.h).
+# PROFILE=debug          -> -Og without link time optimization, so each
+#                           function is still where a debugger or simulator
+#                           expects it. Also profiles the critical sections
+#                           and counts late and missed PWM samples (see
+#                           critical.h).
+#
+# Size and speed build with link time optimization, so the core calls can be
+# inlined across files, and let the linker relax calls and jumps into their
+# shorter forms. All profiles put each function and variable in a section of
+# its own, so anything unused is dropped at link time.
+#
+
+PROFILE ?= size
+
+ifeq ($(PROFILE), size)
+    PROFILE_CFLAGS = -Os -flto -mrelax
+else ifeq ($(PROFILE), speed)
+    PROFILE_CFLAGS = -O2 -flto -mrelax -DOPTIMIZE_FOR_SPEED=1
+else ifeq ($(PROFILE), debug)
+    PROFILE_CFLAGS = -Og -g3 -DENABLE_CRITICAL_PROFILING=1 -DENABLE_OVERRUN_DETECTION=1
+else
+    $(error Unknown PROFILE "$(PROFILE)"; use size, speed or debug)
+endif
+
+PROFILE_CFLAGS  += -ffunction-sections -fdata-sections
+PROFILE_LDFLAGS  = -Wl,--gc-sections
+
+#
+# Size budgets in bytes, set by each Makefile before including this file.
+# Flash counts .text and .data (the initial values are stored in flash), SRAM
+# counts .data, .bss and .noinit. The stack isn't included, so the SRAM budget
+# should leave some room for it.
+#
+
+FLASH_BUDGET ?= 8192
+SRAM_BUDGET  ?= 512
+
+#
+# Per-symbol size report (<target>.sym, largest last) and budget check; part
+# of the .hex recipe so a build over budget never produces anything to flash.
+#
+
+define CHECK_BUDGET
+	avr-nm --size-sort --print-size --radix=d $(TARGET).elf > $(TARGET).sym
+	@avr-size -A $(TARGET).elf | awk -v flash=$(FLASH_BUDGET) -v sram=$(SRAM_BUDGET) \
+		'$$1 == ".text" || $$1 == ".data" { used_flash += $$2 } \
+		 $$1 == ".data" || $$1 == ".bss" || $$1 == ".noinit" { used_sram += $$2 } \
+		 END { printf "$(PROFILE) profile: flash %d/%d bytes, sram %d/%d bytes (see $(TARGET).sym)\n", used_flash, flash, used_sram, sram; \
+		       if ((used_flash > flash) || (used_sram > sram)) { print "Size budget exceeded!"; exit 1 } }'
+endef
@@ -0,0 +1,2355 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Note: The base tempo is kept as a phase accumulator running at the PWM
+//       sample rate, regardless of whether there's an actual waveform output
+//       (the tap-tempo clock uses it just for the sync outputs). On the LFO
+//       boards the waveform output runs off a second phase accumulator, with
+//       the tempo multiplier applied.
+//
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#include "board.h"
+#include "signaling.h"
+#include "critical.h"
+#include "telemetry.h"
+#include "trace.h"
+
+#if ENABLE_WAVEFORM_OUTPUT
+#include "wavetable.h"
+#endif
+
+#if ENABLE_CUSTOM_WAVEFORM
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
+#include "customwave.h"
+#endif
+
+#if ENABLE_TRANSFER_CURVE
+#include <stddef.h>
+
+#include "curves.h"
+#include "customcurve.h"
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+//
+// Calculate duty cycle for multiplier[x] by taking the base duty cycle and
+// multiplying by the correct ratio.
+//
+
+static const float k_multiplier_ratio[MultiplierCount] =
+{
+    0.25,       // Whole note.              (1/4) = 0.25 rate
+    0.333334,   // Dotted half note.        (1/3) = ~0.333334 rate
+    0.5,        // Half note.               (1/2) = 0.5 rate
+    0.666667,   // Dotted quarter note.     (2/3) = ~0.666667 rate
+    1.0,        // Quarter note.            (1/1) = 1 rate
+    1.333334,   // Dotted eighth note.      (4/3) = ~1.333334 rate
+    2.0,        // Eighth note.             (2/1) = 2 rate
+    2.666667,   // Dotted sixteenth note.   (8/3) = ~2,666667 rate
+#if ENABLE_TRIPLET_MULTIPLIER
+    3.0,        // Triplet note.            (3/1) = 3 rate
+#endif
+    4.0         // Sixteenth note.          (4/1) = 4 rate
+};
+
+static const uint8_t k_multiplier_alignment[MultiplierCount] =
+{
+    4,  // Whole note.              Matches base tempo at 4/4.
+    3,  // Dotted half note.        Matches base tempo at 3/4. 
+    2,  // Half note.               Matches base tempo at 2/4.
+    3,  // Dotted quarter note.     Matches base tempo at 3/4.
+    1,  // Quarter note.            Base tempo. 
+    3,  // Dotted eighth note.      Matches base tempo at 3/4.
+    1,  // Eighth note.             Matches base tempo at 1/4.
+    3,  // Dotted sixteenth note.   Matches base tempo at 3/4.
+#if ENABLE_TRIPLET_MULTIPLIER
+    2,  // Triplet note.            Matches base tempo at 1/4.
+#endif
+    1   // Sixteenth note.          Matches base tempo at 1/4.
+};
+
+//
+// Number of base tempo counts between each time all multipliers align.
+//
+
+#define MULTIPLIER_ALIGNMENT_OFFSET     12
+#endif
+
+#if ENABLE_WAVEFORM_MORPH
+//
+// The waveforms a morph passes through, in order. Not quite the selection
+// order; going from ramp up straight to ramp down would flatten out to
+// nothing half way. The random waveform changes every cycle, so it can't be
+// put in a table and is left out.
+//
+
+static const uint8_t k_morph_waveforms[] =
+{
+    WaveformSine,
+    WaveformTriangle,
+    WaveformRampUp,
+    WaveformSquare,
+    WaveformRampDown
+};
+
+#define MORPH_WAVEFORM_COUNT            (sizeof(k_morph_waveforms) / sizeof(k_morph_waveforms[0]))
+#endif
+
+//
+// Book keeping defines.
+//
+
+#define TEMPO_TO_FREQUENCY              1000.0f
+
+#if ENABLE_WAVEFORM_OUTPUT
+//
+// Wave table resolution, i.e. number of steps per cycle in the generated
+// table (see wavetable.h). The phase accumulator always yields an 8-bit
+// index, and only the top WAVETABLE_INDEX_BITS of it are used to look up the
+// table.
+//
+
+#if (WAVETABLE_INDEX_BITS < 2) || (WAVETABLE_INDEX_BITS > 8)
+#error "WAVETABLE_INDEX_BITS must be 2 - 8; regenerate wavetable.h"
+#endif
+
+#define WAVEFORM_RESOLUTION             (1 << WAVETABLE_INDEX_BITS)
+#define WAVEFORM_INDEX_SHIFT            (8 - WAVETABLE_INDEX_BITS)
+
+#if ENABLE_CUSTOM_WAVEFORM
+//
+// Same for the custom waveform, with its 64 levels per cycle. These are
+// expanded into a table with one entry per 8-bit phase index when loaded,
+// so the PWM interrupt needs a single lookup; see LoadCustomWaveform().
+// That's 256 bytes of SRAM, which leaves no room for the morph or output
+// table next to it.
+//
+
+#if CUSTOMWAVE_POINTS != CUSTOM_WAVEFORM_POINTS
+#error "customwave.h doesn't match CUSTOM_WAVEFORM_POINTS; regenerate it"
+#endif
+
+#if ENABLE_WAVEFORM_MORPH || ENABLE_OUTPUT_SCALING
+#error "ENABLE_CUSTOM_WAVEFORM doesn't fit in SRAM with ENABLE_WAVEFORM_MORPH or ENABLE_OUTPUT_SCALING"
+#endif
+
+#define CUSTOM_TABLE_SIZE               256
+#define CUSTOM_ENTRIES_PER_POINT        (CUSTOM_TABLE_SIZE / CUSTOM_WAVEFORM_POINTS)
+#define CUSTOM_ENTRY_SHIFT              2
+#endif
+
+#if ENABLE_TRANSFER_CURVE
+//
+// The transfer curves map one 8-bit output level onto another, so they need
+// an entry for every level.
+//
+
+#if (CURVE_INDEX_BITS != 8) || (CURVE_DEPTH_BITS != 8)
+#error "CURVE_INDEX_BITS and CURVE_DEPTH_BITS must be 8; regenerate curves.h"
+#endif
+
+#if CUSTOMCURVE_POINTS != 256
+#error "CUSTOMCURVE_POINTS must be 256; regenerate customcurve.h"
+#endif
+#endif
+
+//
+// Note: The LFO output is OC0A, and OC0A can't be used as an output with any
+//       other TOP value than 0xff (TOP = OCR0A would use up the compare
+//       register). So the amplitude depth is fixed at 8 bits.
+//
+
+#if WAVETABLE_DEPTH_BITS != 8
+#error "WAVETABLE_DEPTH_BITS must be 8 to match the Timer0 PWM; regenerate wavetable.h"
+#endif
+
+#define PWM_RESOLUTION                  (1 << WAVETABLE_DEPTH_BITS)
+#elif !defined(PWM_RESOLUTION)
+#define PWM_RESOLUTION                  256
+#endif
+
+//
+// PWM timer sample rate based on the PWM (amplitude) resolution:
+// 8Mhz / 256 =  31.25kHz
+// 8MHz / 128 =  62.50kHz
+// 8MHz /  64 = 125.00kHz
+//
+// A board without the waveform output can set its own resolution in
+// board.h, e.g. the attiny861 with its 10-bit LFO outputs. The divisor is
+// worked out from the clock directly, since 8MHz / 1024 isn't a whole number.
+//
+
+#define PWM_SAMPLE_RATE                 (CLOCK_FREQUENCY / PWM_RESOLUTION)
+#define DUTY_CYCLE_DIVISOR              ((0x100000000 * PWM_RESOLUTION) / CLOCK_FREQUENCY)
+
+#if ENABLE_TEMPO_AVERAGING
+#define TEMPO_AVERAGE_MAX_COUNT         10
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+#define WAVEFORM_RANDOM_STEP_COUNT      8
+#define WAVEFORM_STEP_SIZE              (0xff / WAVEFORM_RANDOM_STEP_COUNT)
+
+//
+// Random number generator state to use when seeded with something that
+// would leave it stuck at zero; see SeedRandomNumberGenerator().
+//
+
+#define RANDOM_DEFAULT_STATE            0xace1
+#endif
+
+#if ENABLE_SMOOTH_RANDOM
+//
+// The smooth random and random walk levels stay a little clear of either end
+// of the output range, so that rounding (one sample too many in a cycle) can
+// never carry the level past 0x00 or 0xff; see StartRandomSegment(). The
+// random walk moves at most +/- RANDOM_WALK_STEP_RANGE / 2 per cycle.
+//
+
+#define RANDOM_LEVEL_MIN                0x02
+#define RANDOM_LEVEL_MAX                0xfd
+#define RANDOM_LEVEL_ROUNDING           0x00800000
+#define RANDOM_WALK_STEP_RANGE          64
+#endif
+
+#if ENABLE_WAVEFORM_MORPH
+//
+// The morph table covers a full cycle at the 8-bit phase index resolution,
+// and is rebuilt a few entries per call to UpdateMorphTable(); see there.
+//
+
+#define MORPH_TABLE_SIZE                256
+#define MORPH_ENTRIES_PER_UPDATE        32
+#endif
+
+#if ENABLE_OUTPUT_SCALING && !ENABLE_WAVEFORM_MORPH
+//
+// Same for the output table, which covers every 8-bit output level; see
+// UpdateOutputTable().
+//
+
+#define OUTPUT_TABLE_SIZE               256
+#define OUTPUT_ENTRIES_PER_UPDATE       32
+#endif
+
+#if OSCILLATOR_COUNT > 1
+//
+// There's only SRAM for a single morph or output table, built from one set
+// of morph, depth and offset settings, and a single transfer curve goes with
+// it. Rather than have every other oscillator quietly follow the first one's,
+// they can't be combined with more than one oscillator.
+//
+
+#if ENABLE_WAVEFORM_MORPH || ENABLE_OUTPUT_SCALING || ENABLE_TRANSFER_CURVE
+#error "ENABLE_WAVEFORM_MORPH, ENABLE_OUTPUT_SCALING and ENABLE_TRANSFER_CURVE need OSCILLATOR_COUNT 1"
+#endif
+#endif
+
+#if ENABLE_SKEW
+//
+// Skew limits, i.e. how far the waveform break point can be moved away from
+// the center (0x80); roughly 5% and 95% of a full cycle.
+//
+
+#define SKEW_MIN                        13
+#define SKEW_MAX                        243
+#endif
+
+//
+// Local function prototypes.
+//
+
+void RecalculateTempo();
+uint32_t CalculateBaseDutyCycle(uint16_t tempo);
+
+#if ENABLE_TEMPO_AVERAGING
+uint16_t CalculateAverageTempo(uint16_t tempo);
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+void AlignOscillator(volatile lfo_oscillator *oscillator);
+void RecalculateSkew(volatile lfo_oscillator *oscillator);
+uint32_t CalculatePhaseAccumulator(uint32_t base_phase_accumulator, uint8_t multiplier, uint8_t alignment_index);
+uint8_t SettingsAreValid(const lfo_settings *settings);
+uint8_t PlotSample(volatile lfo_oscillator *oscillator, uint8_t index);
+uint8_t CalculateSample(volatile lfo_oscillator *oscillator, uint8_t waveform, uint8_t index, uint8_t fraction);
+uint8_t ReadSineTable(uint8_t index);
+uint8_t NextRandomNumber();
+uint8_t NextRandomStep();
+#endif
+
+#if ENABLE_SKEW
+void CalculateSkewDutyCycles(uint32_t duty_cycle, uint8_t skew, uint32_t *first_half_duty_cycle, uint32_t *second_half_duty_cycle);
+#endif
+
+#if ENABLE_SMOOTH_RANDOM
+void StartRandomSegment(volatile lfo_oscillator *oscillator);
+uint32_t CalculateRandomStep(uint32_t duty_cycle, int16_t delta);
+#endif
+
+#if ENABLE_SINE_INTERPOLATION
+uint8_t InterpolateSineTable(uint8_t index, uint8_t fraction);
+#endif
+
+#if ENABLE_OUTPUT_SCALING && ENABLE_WAVEFORM_MORPH
+uint8_t ScaleOutput(uint8_t sample);
+#endif
+
+//
+// Global variables.
+//
+
+volatile uint16_t g_base_tempo;
+
+volatile uint32_t g_base_duty_cycle;
+volatile uint8_t g_base_table_index = 0xff;
+volatile uint32_t g_base_phase_accumulator;
+
+#if ENABLE_TELEMETRY
+volatile int16_t g_sync_error;
+#endif
+
+#if ENABLE_SPEED_ADJUST
+volatile int16_t g_tempo_adjust_offset;
+
+volatile uint8_t g_speed_adjust_multiplier = 1;
+volatile uint16_t g_continuous_speed_adjustments;
+volatile uint16_t g_speed_adjust_ms_count;
+#endif
+
+#if ENABLE_TEMPO_AVERAGING
+volatile uint16_t g_average_tempo[TEMPO_AVERAGE_MAX_COUNT];
+volatile uint8_t g_average_tempo_count = 0;
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+volatile uint16_t g_random_state = RANDOM_DEFAULT_STATE;
+
+//
+// The waveform oscillators; see lfo_oscillator. The first one starts out
+// active, writing to the board's LFO output, with the same defaults
+// InitializeOscillator() gives the others.
+//
+
+volatile lfo_oscillator g_oscillators[OSCILLATOR_COUNT] =
+{
+    {
+        .waveform = WaveformSine,
+        .multiplier = MultiplierQuarter,
+#if ENABLE_SKEW
+        .skew = 0x80,
+#endif
+#if ENABLE_SMOOTH_RANDOM
+        .random_level = ((uint32_t)0x80 << 24) + RANDOM_LEVEL_ROUNDING,
+        .random_target = 0x80,
+#endif
+        .output_compare = &LFO_OUTPUT_COMPARE,
+        .is_active = 1
+    }
+};
+#endif
+
+#if ENABLE_SECOND_OUTPUT
+volatile uint8_t g_second_output_offset = SECOND_OUTPUT_DEFAULT_OFFSET;
+#endif
+
+#if ENABLE_CUSTOM_WAVEFORM
+volatile uint8_t g_custom_waveform[CUSTOM_TABLE_SIZE];
+#endif
+
+#if ENABLE_TRANSFER_CURVE
+//
+// The selected transfer curve, and its table in flash; NULL for linear,
+// which has none.
+//
+
+volatile uint8_t g_transfer_curve = TransferCurveLinear;
+const uint8_t * volatile g_transfer_curve_table;
+#endif
+
+#if ENABLE_WAVEFORM_MORPH
+volatile uint8_t g_morph_table[MORPH_TABLE_SIZE];
+volatile uint8_t g_morph_position;
+volatile uint8_t g_morph_table_changed;
+
+uint16_t g_morph_entries_left;      // Main loop only.
+uint8_t g_morph_rebuild_index;      // Main loop only.
+#endif
+
+#if ENABLE_OUTPUT_SCALING
+volatile uint8_t g_output_depth = OUTPUT_DEFAULT_DEPTH;
+volatile uint8_t g_output_offset = OUTPUT_DEFAULT_OFFSET;
+
+#if !ENABLE_WAVEFORM_MORPH
+volatile uint8_t g_output_table[OUTPUT_TABLE_SIZE];
+volatile uint8_t g_output_table_changed;
+
+uint16_t g_output_entries_left;     // Main loop only.
+uint8_t g_output_rebuild_index;     // Main loop only.
+#endif
+#endif
+
+#if ENABLE_QUEUED_SETTINGS
+//
+// Settings waiting to be applied to an oscillator at the next base cycle
+// boundary; see QueueOscillatorSettings(). Duty cycles are precalculated for
+// every oscillator, since a new base tempo moves them all, so there's
+// nothing left to work out in the PWM interrupt.
+//
+
+volatile lfo_settings g_queued_settings;
+volatile uint8_t g_queued_oscillator;
+volatile uint32_t g_queued_base_duty_cycle;
+volatile uint32_t g_queued_duty_cycle[OSCILLATOR_COUNT];
+#if ENABLE_SKEW
+volatile uint32_t g_queued_first_half_duty_cycle[OSCILLATOR_COUNT];
+volatile uint32_t g_queued_second_half_duty_cycle[OSCILLATOR_COUNT];
+#endif
+volatile uint8_t g_has_queued_settings;
+#endif
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void SetBaseTempo(uint16_t milliseconds)
+{
+    TRACE(TraceEventTempo, milliseconds);
+    
+    //
+    // Do some boundary checking on the requested frequency. We're only going
+    // to accept frequencies in the range of 0.1Hz - 20Hz.
+    //
+    
+    if ((milliseconds > LFO_MIN_TEMPO) || (milliseconds < LFO_MAX_TEMPO))
+    {
+        return;
+    }
+    
+#if ENABLE_TEMPO_AVERAGING
+    //
+    // If tempo averaging is enabled the current reading is passed on for
+    // further calculation and will more than likely be modified somewhat.
+    //
+    
+    if (TEMPO_AVERAGING_IS_ACTIVE())
+    {
+        milliseconds = CalculateAverageTempo(milliseconds);
+    }
+#endif
+    
+    //
+    // No need to recalculate if the new tempo count is just a few milliseconds
+    // off (would be typical when running off an external clock pulse).
+    //
+    // 2ms +/- seems to eliminate any syncing irregularities when clocked from
+    // an external tap-tempo chip.
+    //
+    
+    if ((g_base_tempo > (milliseconds + 2)) || (g_base_tempo < (milliseconds - 2)))
+    {
+        //
+        // Store the new base tempo and recalculate how that affects the actual
+        // output.
+        //
+        
+        g_base_tempo = milliseconds;
+#if ENABLE_SPEED_ADJUST
+        g_tempo_adjust_offset = 0;
+#endif
+        
+        RecalculateTempo();
+    }        
+}
+
+void StartTempoCount()
+{
+    //
+    // Sync the output and start the tempo counting.
+    //
+    
+    g_tempo_ms_count = 0;
+    g_state.is_counting_tempo = 1;
+    
+    ResetBaseTempo();
+#if ENABLE_WAVEFORM_OUTPUT
+    AlignWaveform();
+#endif
+    
+    TEMPO_COUNT_STARTED();
+}
+
+void StopTempoCount()
+{
+    //
+    // Set the new tempo and reset the tempo counting state.
+    //
+    
+    if (g_state.is_counting_tempo == 1)
+    {
+        g_state.is_counting_tempo = 0;
+        
+#if ENABLE_TELEMETRY
+        //
+        // Keep track of how far the new count is from the tempo we've been
+        // running at; i.e. how well we're locked to a sync input.
+        //
+        
+        g_sync_error = (int16_t)(g_tempo_ms_count - g_base_tempo);
+#endif
+        
+        SetBaseTempo(g_tempo_ms_count);
+        g_tempo_ms_count = 0;
+    }
+    
+    ResetBaseTempo();
+#if ENABLE_WAVEFORM_OUTPUT
+    AlignWaveform();
+#endif
+    
+    TEMPO_COUNT_STOPPED();
+}
+
+void TempoCountTimeout()
+{
+    //
+    // Exit the tempo counting state without making any changes, discarding any
+    // tempo count.
+    //
+    
+    g_state.is_counting_tempo = 0;
+    g_tempo_ms_count = 0;
+    
+    TEMPO_COUNT_TIMED_OUT();
+}
+
+void ResetBaseTempo()
+{
+    //
+    // Reset phase accumulator and wave table index for the base tempo.
+    //
+    
+    TRACE(TraceEventBaseReset, g_base_phase_accumulator >> 16);
+    
+    g_base_table_index = 0;
+    g_base_phase_accumulator = 0;
+}
+
+uint8_t ScaleStep(uint8_t step, uint8_t fraction)
+{
+    uint16_t product = 0;
+    uint16_t addend = fraction;
+    
+    //
+    // step * fraction / 256, with shifts and adds only; there's no hardware
+    // multiplier on the attiny, and the library multiply would eat a good
+    // part of the PWM interrupt. It takes one round per bit of the step, and
+    // neighbouring sine entries are never more than 4 apart with the default
+    // 256 step table, so that's three rounds at the most (four for the
+    // tap-tempo clock's 10-bit LFO channels, at up to 13 apart).
+    //
+    
+    while (step != 0)
+    {
+        if (step & 0x01)
+        {
+            product += addend;
+        }
+        
+        addend <<= 1;
+        step >>= 1;
+    }
+    
+    return product >> 8;
+}
+
+#if ENABLE_SPEED_ADJUST
+void AdjustSpeed(int16_t change_value)
+{
+    //
+    // Make sure the result doesn't exceed either upper or lower LFO limits.
+    //
+    
+    int16_t new_tempo_count = g_base_tempo + g_tempo_adjust_offset + change_value;
+    
+    if ((new_tempo_count > LFO_MIN_TEMPO) || (new_tempo_count < LFO_MAX_TEMPO))
+    {
+        return;
+    }
+    
+    g_tempo_adjust_offset += change_value;
+    RecalculateTempo();
+}
+
+void ResetSpeedAdjustSetting()
+{
+    g_tempo_adjust_offset = 0;
+    RecalculateTempo();
+}
+
+void ModifySpeedAdjust(int8_t change_value)
+{
+    //
+    // Dynamically increase and decrease the amount of adjustment applied based
+    // on whether the user is quickly or slowly making adjustments.
+    //
+    // Note: Probably have to be tweaked for optimal "feel". Will also be
+    //       affected by the detent count of the rotary encoder and the radius
+    //       of the knob used.
+    //
+    
+    if (g_speed_adjust_ms_count < 100)
+    {
+        //
+        // Less than 100ms since previous user input. Counting this as
+        // continuous input.
+        //
+        
+        g_continuous_speed_adjustments++;
+        
+        //
+        // For every 10 continuous input triggers, increase the size of each
+        // speed adjustment step. 
+        //
+        
+        if ((g_continuous_speed_adjustments % 10) == 0)
+        {
+            g_speed_adjust_multiplier += 10;
+        }
+    }
+    else if (g_speed_adjust_ms_count > 1000)
+    {
+        //
+        // No user input in a full second. Reset any continuous adjust state.
+        //
+        
+        g_speed_adjust_multiplier = 1;
+        g_continuous_speed_adjustments = 0;
+    }
+    
+    //
+    // Reset the millisecond count since last user input.
+    //
+    
+    g_speed_adjust_ms_count = 0;
+    
+    //
+    // Adjust the speed by the current speed adjust multiplier. Multiply by -1
+    // to swap polarity and the direction in which speed increase and decrease.
+    //
+    
+    AdjustSpeed(g_speed_adjust_multiplier * change_value * -1);
+}
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+void ResetSignals()
+{
+    uint8_t count;
+    
+    ResetBaseTempo();
+    
+    for (count = 0; count < OSCILLATOR_COUNT; count++)
+    {
+        g_oscillators[count].phase_accumulator = 0;
+        g_oscillators[count].table_index = 0;
+        
+        g_oscillators[count].multiplier_alignment_index = 0;
+        
+#if ENABLE_SMOOTH_RANDOM
+        //
+        // A new segment only starts when the table index wraps, which is now
+        // a whole cycle away. Hold the random level at its target until then
+        // rather than have it keep going at the old step; see
+        // SelectOscillatorMultiplier().
+        //
+        
+        g_oscillators[count].random_level = ((uint32_t)g_oscillators[count].random_target << 24) + RANDOM_LEVEL_ROUNDING;
+        g_oscillators[count].random_step = 0;
+        g_oscillators[count].random_delta = 0;
+#endif
+    }
+}
+
+void GetSettings(lfo_settings *settings)
+{
+    GetOscillatorSettings(0, settings);
+}
+
+void GetOscillatorSettings(uint8_t number, lfo_settings *settings)
+{
+    volatile lfo_oscillator *oscillator = &g_oscillators[number];
+    
+    //
+    // The oscillator's own waveform, multiplier and skew, along with the
+    // base tempo and everything else that's shared by all of them.
+    //
+    
+    if (number >= OSCILLATOR_COUNT)
+    {
+        return;
+    }
+    
+    settings->base_tempo = g_base_tempo;
+#if ENABLE_SPEED_ADJUST
+    settings->tempo_adjust_offset = g_tempo_adjust_offset;
+#endif
+    settings->waveform = oscillator->waveform;
+    settings->multiplier = oscillator->multiplier;
+#if ENABLE_WAVEFORM_MORPH
+    settings->morph_position = g_morph_position;
+#endif
+#if ENABLE_SKEW
+    settings->skew = oscillator->skew;
+#endif
+#if ENABLE_SECOND_OUTPUT
+    settings->second_output_offset = g_second_output_offset;
+#endif
+#if ENABLE_TRANSFER_CURVE
+    settings->transfer_curve = g_transfer_curve;
+#endif
+#if ENABLE_OUTPUT_SCALING
+    settings->output_depth = g_output_depth;
+    settings->output_offset = g_output_offset;
+#endif
+}
+
+void ApplySettings(const lfo_settings *settings)
+{
+    ApplyOscillatorSettings(0, settings);
+}
+
+void ApplyOscillatorSettings(uint8_t number, const lfo_settings *settings)
+{
+    volatile lfo_oscillator *oscillator = &g_oscillators[number];
+    
+    //
+    // The settings may come from somewhere less trustworthy than our own
+    // variables, so check everything is within bounds before using any of it.
+    //
+    
+    if ((number >= OSCILLATOR_COUNT) || !SettingsAreValid(settings))
+    {
+        return;
+    }
+    
+    g_base_tempo = settings->base_tempo;
+#if ENABLE_SPEED_ADJUST
+    g_tempo_adjust_offset = settings->tempo_adjust_offset;
+#endif
+    oscillator->waveform = settings->waveform;
+    oscillator->multiplier = settings->multiplier;
+#if ENABLE_WAVEFORM_MORPH
+    SetMorphPosition(settings->morph_position);
+#endif
+#if ENABLE_SKEW
+    oscillator->skew = settings->skew;
+#endif
+#if ENABLE_SECOND_OUTPUT
+    g_second_output_offset = settings->second_output_offset;
+#endif
+#if ENABLE_TRANSFER_CURVE
+    SelectTransferCurve(settings->transfer_curve);
+#endif
+#if ENABLE_OUTPUT_SCALING
+    SetOutputDepth(settings->output_depth);
+    SetOutputOffset(settings->output_offset);
+#endif
+    
+    RecalculateTempo();
+}
+
+#if ENABLE_QUEUED_SETTINGS
+uint8_t QueueSettings(const lfo_settings *settings)
+{
+    return QueueOscillatorSettings(0, settings);
+}
+
+uint8_t QueueOscillatorSettings(uint8_t number, const lfo_settings *settings)
+{
+    uint32_t base_duty_cycle;
+    uint32_t duty_cycle[OSCILLATOR_COUNT];
+#if ENABLE_SKEW
+    uint32_t first_half_duty_cycle[OSCILLATOR_COUNT];
+    uint32_t second_half_duty_cycle[OSCILLATOR_COUNT];
+    uint8_t skew;
+#endif
+    uint8_t multiplier;
+    uint8_t count;
+    
+    //
+    // Like ApplyOscillatorSettings(), but rather than changing the output
+    // right away (and glitching it) leave the change for
+    // ApplyQueuedSettings() to pick up at the next base cycle boundary. All
+    // the floating point work is done here, outside of any interrupt; for
+    // the other oscillators too, which keep their own multiplier and skew
+    // but follow the new base tempo.
+    //
+    
+    if ((number >= OSCILLATOR_COUNT) || !SettingsAreValid(settings))
+    {
+        return 0;
+    }
+    
+#if ENABLE_SPEED_ADJUST
+    base_duty_cycle = CalculateBaseDutyCycle(settings->base_tempo + settings->tempo_adjust_offset);
+#else
+    base_duty_cycle = CalculateBaseDutyCycle(settings->base_tempo);
+#endif
+    
+    for (count = 0; count < OSCILLATOR_COUNT; count++)
+    {
+        multiplier = (count == number) ? settings->multiplier : g_oscillators[count].multiplier;
+        duty_cycle[count] = base_duty_cycle * k_multiplier_ratio[multiplier];
+        
+#if ENABLE_SKEW
+        skew = (count == number) ? settings->skew : g_oscillators[count].skew;
+        CalculateSkewDutyCycles(duty_cycle[count], skew, &first_half_duty_cycle[count], &second_half_duty_cycle[count]);
+#endif
+    }
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionQueue)
+    {
+        g_queued_settings.base_tempo = settings->base_tempo;
+#if ENABLE_SPEED_ADJUST
+        g_queued_settings.tempo_adjust_offset = settings->tempo_adjust_offset;
+#endif
+        g_queued_settings.waveform = settings->waveform;
+        g_queued_settings.multiplier = settings->multiplier;
+#if ENABLE_WAVEFORM_MORPH
+        g_queued_settings.morph_position = settings->morph_position;
+#endif
+#if ENABLE_SKEW
+        g_queued_settings.skew = settings->skew;
+#endif
+#if ENABLE_SECOND_OUTPUT
+        g_queued_settings.second_output_offset = settings->second_output_offset;
+#endif
+#if ENABLE_TRANSFER_CURVE
+        g_queued_settings.transfer_curve = settings->transfer_curve;
+#endif
+#if ENABLE_OUTPUT_SCALING
+        g_queued_settings.output_depth = settings->output_depth;
+        g_queued_settings.output_offset = settings->output_offset;
+#endif
+        
+        g_queued_base_duty_cycle = base_duty_cycle;
+        
+        for (count = 0; count < OSCILLATOR_COUNT; count++)
+        {
+            g_queued_duty_cycle[count] = duty_cycle[count];
+#if ENABLE_SKEW
+            g_queued_first_half_duty_cycle[count] = first_half_duty_cycle[count];
+            g_queued_second_half_duty_cycle[count] = second_half_duty_cycle[count];
+#endif
+        }
+        
+        g_queued_oscillator = number;
+        g_has_queued_settings = 1;
+    }
+    
+    return 1;
+}
+
+void ApplyQueuedSettings()
+{
+    volatile lfo_oscillator *oscillator = &g_oscillators[g_queued_oscillator];
+    uint8_t count;
+    
+    //
+    // Called from the PWM interrupt whenever the base tempo completes a
+    // cycle. Only plain assignments, one set of duty cycles per oscillator,
+    // so this is done well within a single PWM period.
+    //
+    // The queued oscillator's multiplier alignment is started over, so its
+    // new waveform starts from the beginning in step with the base tempo;
+    // see AlignWaveform().
+    //
+    
+    if (g_has_queued_settings == 0)
+    {
+        return;
+    }
+    
+    g_base_tempo = g_queued_settings.base_tempo;
+#if ENABLE_SPEED_ADJUST
+    g_tempo_adjust_offset = g_queued_settings.tempo_adjust_offset;
+#endif
+    oscillator->waveform = g_queued_settings.waveform;
+    oscillator->multiplier = g_queued_settings.multiplier;
+#if ENABLE_WAVEFORM_MORPH
+    SetMorphPosition(g_queued_settings.morph_position);
+#endif
+#if ENABLE_SKEW
+    oscillator->skew = g_queued_settings.skew;
+#endif
+    
+    g_base_duty_cycle = g_queued_base_duty_cycle;
+    
+    for (count = 0; count < OSCILLATOR_COUNT; count++)
+    {
+        if (g_oscillators[count].is_active)
+        {
+            g_oscillators[count].duty_cycle = g_queued_duty_cycle[count];
+#if ENABLE_SKEW
+            g_oscillators[count].first_half_duty_cycle = g_queued_first_half_duty_cycle[count];
+            g_oscillators[count].second_half_duty_cycle = g_queued_second_half_duty_cycle[count];
+#endif
+        }
+    }
+#if ENABLE_SECOND_OUTPUT
+    g_second_output_offset = g_queued_settings.second_output_offset;
+#endif
+#if ENABLE_TRANSFER_CURVE
+    SelectTransferCurve(g_queued_settings.transfer_curve);
+#endif
+#if ENABLE_OUTPUT_SCALING
+    SetOutputDepth(g_queued_settings.output_depth);
+    SetOutputOffset(g_queued_settings.output_offset);
+#endif
+    
+    oscillator->multiplier_alignment_index = 0;
+    AlignWaveform();
+    
+    g_has_queued_settings = 0;
+}
+#endif
+
+void SeedRandomNumberGenerator(uint32_t seed)
+{
+    uint16_t state = seed ^ (seed >> 16);
+    
+    //
+    // A zero state would never change again; see NextRandomNumber().
+    //
+    
+    if (state == 0)
+    {
+        state = RANDOM_DEFAULT_STATE;
+    }
+    
+    g_random_state = state;
+}
+
+void UpdateRandomNumber()
+{
+    uint8_t count;
+    
+    //
+    // Give each oscillator a new "random" number for the random waveform.
+    //
+    
+    for (count = 0; count < OSCILLATOR_COUNT; count++)
+    {
+        g_oscillators[count].random_number = NextRandomStep();
+    }
+}
+
+void PlotWaveform()
+{
+    uint8_t previous_table_index = g_oscillators[0].table_index;
+    uint8_t count;
+#if ENABLE_SECOND_OUTPUT
+    uint8_t index;
+#endif
+    
+    //
+    // Render a single sample from each of the active oscillators, straight
+    // to its PWM compare register. Each one adds a RenderOscillatorSample()
+    // for its own waveform, which costs anything from a ramp's few cycles to
+    // a new random segment, and the first one also pays for the second
+    // output and the cycle hook below. The whole lot has to fit the PWM
+    // period; "make bench" reports the cycles per oscillator.
+    //
+    
+    for (count = 0; count < OSCILLATOR_COUNT; count++)
+    {
+        if (g_oscillators[count].is_active)
+        {
+            *g_oscillators[count].output_compare = RenderOscillatorSample(&g_oscillators[count]);
+        }
+    }
+    
+#if ENABLE_SECOND_OUTPUT
+    //
+    // The second output plots the first oscillator's waveform from the same
+    // phase, only further along by its offset, so the two can never drift
+    // apart.
+    //
+    
+#if ENABLE_PHASE_OFFSET
+    index = g_oscillators[0].table_index + g_oscillators[0].phase_offset;
+#else
+    index = g_oscillators[0].table_index;
+#endif
+    
+    SECOND_OUTPUT_COMPARE = PlotSample(&g_oscillators[0], index + g_second_output_offset);
+#endif
+    
+    //
+    // If applicable, toggle the actual tempo indicator.
+    //
+    
+    if (previous_table_index > g_oscillators[0].table_index)
+    {
+        WAVEFORM_CYCLE_COMPLETED();
+    }
+}
+
+void AlignWaveform()
+{
+    uint8_t count;
+    
+    //
+    // Called whenever the base tempo starts a new cycle; see
+    // AlignOscillator().
+    //
+    
+    for (count = 0; count < OSCILLATOR_COUNT; count++)
+    {
+        if (g_oscillators[count].is_active)
+        {
+            AlignOscillator(&g_oscillators[count]);
+        }
+    }
+}
+
+void InitializeOscillator(uint8_t number, volatile uint8_t *output_compare)
+{
+    volatile lfo_oscillator *oscillator = &g_oscillators[number];
+    
+    //
+    // Start (or restart) an oscillator with the defaults; sine, 1:1 tempo and
+    // no skew, writing to the given PWM compare register. It's kept inactive
+    // until everything is set up, so the PWM interrupt leaves it alone
+    // meanwhile. The phase starts from zero, and is lined up with the base
+    // tempo at the next base cycle; see AlignWaveform().
+    //
+    
+    if (number >= OSCILLATOR_COUNT)
+    {
+        return;
+    }
+    
+    oscillator->is_active = 0;
+    
+    oscillator->phase_accumulator = 0;
+    oscillator->table_index = 0;
+    oscillator->waveform = WaveformSine;
+    oscillator->multiplier = MultiplierQuarter;
+    oscillator->multiplier_alignment_index = 0;
+    oscillator->random_number = NextRandomStep();
+#if ENABLE_SKEW
+    oscillator->skew = 0x80;
+#endif
+#if ENABLE_PHASE_OFFSET
+    oscillator->phase_offset = 0;
+#endif
+#if ENABLE_SMOOTH_RANDOM
+    oscillator->random_level = ((uint32_t)0x80 << 24) + RANDOM_LEVEL_ROUNDING;
+    oscillator->random_delta = 0;
+    oscillator->random_target = 0x80;
+#endif
+    oscillator->output_compare = output_compare;
+    
+    SetOscillatorTempo(oscillator);
+    
+    oscillator->is_active = 1;
+}
+
+void SetOscillatorTempo(volatile lfo_oscillator *oscillator)
+{
+    //
+    // Use the base duty cycle and the oscillator's multiplier to calculate
+    // its working duty cycle, and everything else that follows from it.
+    //
+    
+    oscillator->duty_cycle = g_base_duty_cycle * k_multiplier_ratio[oscillator->multiplier];
+    
+#if ENABLE_SKEW
+    RecalculateSkew(oscillator);
+#endif
+    
+#if ENABLE_SMOOTH_RANDOM
+    //
+    // The random level step depends on the duty cycle; with the new one the
+    // level carries on to its target in step with the (now faster or slower)
+    // cycle.
+    //
+    
+    oscillator->random_step = CalculateRandomStep(oscillator->duty_cycle, oscillator->random_delta);
+#endif
+}
+
+uint8_t RenderOscillatorSample(volatile lfo_oscillator *oscillator)
+{
+    uint8_t previous_table_index = oscillator->table_index;
+    uint8_t index;
+    uint8_t sample;
+    
+    //
+    // Calculate the next waveform table index. The phase accumulator keeps
+    // track of the current offset within a single waveform, and the duty cycle
+    // is a fixed "step" that gets added each interrupt. The given frequency
+    // will have an impact on the size of the duty cycle, and we'll complete
+    // the full waveform slower or faster based on each of these steps.
+    //
+    
+#if ENABLE_SKEW
+    //
+    // With a skewed waveform each half of the cycle has its own step size
+    // (see RecalculateSkew()), which moves the break point without changing
+    // the length of the full cycle.
+    //
+    
+    if (oscillator->table_index < 0x80)
+    {
+        oscillator->phase_accumulator += oscillator->first_half_duty_cycle;
+    }
+    else
+    {
+        oscillator->phase_accumulator += oscillator->second_half_duty_cycle;
+    }
+#else
+    oscillator->phase_accumulator += oscillator->duty_cycle;
+#endif
+    oscillator->table_index = (oscillator->phase_accumulator & 0xff000000) >> 24;
+    
+#if ENABLE_SMOOTH_RANDOM
+    //
+    // Move the smooth random (or random walk) level one step closer to its
+    // target. The step is worked out once per cycle, so this is a single
+    // add; done regardless of the selected waveform to keep it unconditional.
+    //
+    
+    oscillator->random_level += oscillator->random_step;
+#endif
+    
+#if ENABLE_PHASE_OFFSET
+    index = oscillator->table_index + oscillator->phase_offset;
+#else
+    index = oscillator->table_index;
+#endif
+    
+    sample = PlotSample(oscillator, index);
+    
+    if (previous_table_index > oscillator->table_index)
+    {
+        //
+        // Update the random number for the random waveform.
+        //
+        
+        oscillator->random_number = NextRandomStep();
+        
+#if ENABLE_SMOOTH_RANDOM
+        StartRandomSegment(oscillator);
+#endif
+    }
+    
+    return sample;
+}
+
+uint8_t GetWaveform()
+{
+    return g_oscillators[0].waveform;
+}
+
+void SelectWaveform(uint8_t waveform)
+{
+    SelectOscillatorWaveform(0, waveform);
+}
+
+void SelectOscillatorWaveform(uint8_t number, uint8_t waveform)
+{
+    //
+    // How a waveform gets picked (potentiometer, push button etc.) is up to
+    // the board; all that's needed here is a valid index.
+    //
+    
+    if ((number < OSCILLATOR_COUNT) && (waveform < WaveformCount))
+    {
+        g_oscillators[number].waveform = waveform;
+    }
+}
+
+uint8_t GetMultiplier()
+{
+    return g_oscillators[0].multiplier;
+}
+
+void SelectMultiplier(uint8_t multiplier)
+{
+    SelectOscillatorMultiplier(0, multiplier);
+}
+
+void SelectOscillatorMultiplier(uint8_t number, uint8_t multiplier)
+{
+    volatile lfo_oscillator *oscillator = &g_oscillators[number];
+    uint32_t base_duty_cycle;
+    uint32_t base_phase_accumulator;
+    uint32_t duty_cycle;
+    uint32_t phase_accumulator;
+#if ENABLE_SKEW
+    uint32_t first_half_duty_cycle;
+    uint32_t second_half_duty_cycle;
+#endif
+    
+    //
+    // Only change the multiplier if it's valid and different, and keep the
+    // output in step with the base tempo when it does change.
+    //
+    
+    if ((number >= OSCILLATOR_COUNT) || (multiplier >= MultiplierCount) || (multiplier == oscillator->multiplier))
+    {
+        return;
+    }
+    
+    //
+    // This is called from the main loop, so the floating point work is done
+    // with interrupts on, from a snapshot of the base tempo, and only the
+    // results are handed over atomically (as in QueueSettings()). The new
+    // phase is then a few PWM periods behind at the most, which the next
+    // base cycle lines up again; see AlignWaveform().
+    //
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        base_duty_cycle = g_base_duty_cycle;
+        base_phase_accumulator = g_base_phase_accumulator;
+    }
+    
+    duty_cycle = base_duty_cycle * k_multiplier_ratio[multiplier];
+    phase_accumulator = CalculatePhaseAccumulator(base_phase_accumulator, multiplier, oscillator->multiplier_alignment_index);
+#if ENABLE_SKEW
+    CalculateSkewDutyCycles(duty_cycle, oscillator->skew, &first_half_duty_cycle, &second_half_duty_cycle);
+#endif
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        oscillator->multiplier = multiplier;
+        oscillator->duty_cycle = duty_cycle;
+        oscillator->phase_accumulator = phase_accumulator;
+#if ENABLE_SKEW
+        oscillator->first_half_duty_cycle = first_half_duty_cycle;
+        oscillator->second_half_duty_cycle = second_half_duty_cycle;
+#endif
+        
+#if ENABLE_SMOOTH_RANDOM
+        //
+        // With the phase moved the random level no longer matches it, and
+        // could overshoot its target before the cycle completes. Hold it at
+        // the target for the rest of this cycle instead.
+        //
+        
+        oscillator->random_level = ((uint32_t)oscillator->random_target << 24) + RANDOM_LEVEL_ROUNDING;
+        oscillator->random_step = 0;
+        oscillator->random_delta = 0;
+#endif
+    }
+}
+
+#if ENABLE_SKEW
+uint8_t GetSkew()
+{
+    return g_oscillators[0].skew;
+}
+
+void SetSkew(uint8_t value)
+{
+    SetOscillatorSkew(0, value);
+}
+
+void SetOscillatorSkew(uint8_t number, uint8_t value)
+{
+    volatile lfo_oscillator *oscillator = &g_oscillators[number];
+    
+    //
+    // Move the break point of the waveform (the peak of the triangle, the
+    // edge of the square etc.) anywhere between ~5% and ~95% of a full cycle.
+    //
+    
+    if (number >= OSCILLATOR_COUNT)
+    {
+        return;
+    }
+    
+    if (value < SKEW_MIN)
+    {
+        value = SKEW_MIN;
+    }
+    else if (value > SKEW_MAX)
+    {
+        value = SKEW_MAX;
+    }
+    
+    if (value != oscillator->skew)
+    {
+        oscillator->skew = value;
+        
+        RecalculateSkew(oscillator);
+    }
+}
+#endif
+
+#if ENABLE_PHASE_OFFSET
+void SetPhaseOffset(uint8_t value)
+{
+    SetOscillatorPhaseOffset(0, value);
+}
+
+void SetOscillatorPhaseOffset(uint8_t number, uint8_t value)
+{
+    //
+    // The full 8-bit value maps directly onto a full cycle (0 - 360 degrees),
+    // and is simply added to the table index when plotting.
+    //
+    
+    if (number < OSCILLATOR_COUNT)
+    {
+        g_oscillators[number].phase_offset = value;
+    }
+}
+#endif
+
+#if ENABLE_SECOND_OUTPUT
+uint8_t GetSecondOutputOffset()
+{
+    return g_second_output_offset;
+}
+
+void SetSecondOutputOffset(uint8_t value)
+{
+    //
+    // Same as SetPhaseOffset(), but for the second output, relative to the
+    // first; e.g. 0x40 for quadrature, 0x80 for opposite phase.
+    //
+    
+    g_second_output_offset = value;
+}
+#endif
+
+#if ENABLE_CUSTOM_WAVEFORM
+uint8_t LoadCustomWaveform()
+{
+    custom_waveform_record record;
+    uint16_t crc = CUSTOM_WAVEFORM_CRC_SEED;
+    uint8_t count;
+    uint8_t entry;
+    uint8_t is_stored;
+    uint8_t *table;
+    int16_t level;
+    int16_t step;
+    
+    //
+    // Pick up the custom waveform uploaded to EEPROM, if there is one and it
+    // came through intact. Anything else (never uploaded, erased, cut short
+    // or otherwise damaged) falls back to the one built into the firmware,
+    // so a bad upload only ever costs the custom waveform, never the unit.
+    // Returns 1 if the EEPROM one is in use.
+    //
+    // The 64 points are then expanded into the 256 entry table the PWM
+    // interrupt reads, four entries per point, each stepping a quarter of
+    // the way on towards the next point (the last one leading back into
+    // the first). Doing it here, once, keeps the per sample cost down to a
+    // single lookup, whatever the shape; blending neighbouring points in
+    // the interrupt took up to eight ScaleStep() rounds on the steep parts.
+    //
+    // Note: Call before the PWM interrupt starts reading the table. Reading
+    //       from RAM costs the PWM interrupt no more than the sine table in
+    //       flash does.
+    //
+    
+    eeprom_read_block(&record, (const void *)CUSTOM_WAVEFORM_EEPROM_ADDRESS, sizeof(custom_waveform_record));
+    
+    for (count = 0; count < CUSTOM_WAVEFORM_POINTS; count++)
+    {
+        crc = _crc16_update(crc, record.points[count]);
+    }
+    
+    is_stored = (crc == record.crc);
+    
+    if (!is_stored)
+    {
+        for (count = 0; count < CUSTOM_WAVEFORM_POINTS; count++)
+        {
+            record.points[count] = pgm_read_byte(&k_custom_waveform[count]);
+        }
+    }
+    
+    table = (uint8_t *)g_custom_waveform;
+    
+    for (count = 0; count < CUSTOM_WAVEFORM_POINTS; count++)
+    {
+        level = (int16_t)record.points[count] << CUSTOM_ENTRY_SHIFT;
+        step = (int16_t)record.points[(count + 1) & (CUSTOM_WAVEFORM_POINTS - 1)] - record.points[count];
+        
+        for (entry = 0; entry < CUSTOM_ENTRIES_PER_POINT; entry++)
+        {
+            *table++ = level >> CUSTOM_ENTRY_SHIFT;
+            level += step;
+        }
+    }
+    
+    return is_stored;
+}
+#endif
+
+#if ENABLE_TRANSFER_CURVE
+uint8_t GetTransferCurve()
+{
+    return g_transfer_curve;
+}
+
+void SelectTransferCurve(uint8_t curve)
+{
+    const uint8_t *table;
+    
+    //
+    // The transfer curve is the very last stage of the output, after depth,
+    // offset etc., e.g. to straighten out the response of an LED/LDR
+    // (vactrol) driven by the output. Wherever there's a table the output
+    // already passes through (the morph table, the output table) the curve
+    // is folded into it here, so the PWM interrupt costs the same whatever
+    // the curve. Otherwise it's a single lookup in flash; see
+    // ApplyTransferCurve().
+    //
+    
+    if ((curve >= TransferCurveCount) || (curve == g_transfer_curve))
+    {
+        return;
+    }
+    
+    switch (curve)
+    {
+        case TransferCurveExponential:
+        
+            table = k_exp_curve;
+            break;
+        
+        case TransferCurveLogarithmic:
+        
+            table = k_log_curve;
+            break;
+        
+        case TransferCurveCustom:
+        
+            table = k_custom_curve;
+            break;
+        
+        case TransferCurveLinear:
+        default:
+        
+            table = NULL;
+            break;
+    }
+    
+    //
+    // The table pointer is 16 bits, and read by the PWM interrupt.
+    //
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        g_transfer_curve = curve;
+        g_transfer_curve_table = table;
+    }
+    
+#if ENABLE_WAVEFORM_MORPH
+    RebuildMorphTable();
+#elif ENABLE_OUTPUT_SCALING
+    RebuildOutputTable();
+#endif
+}
+
+uint8_t ApplyTransferCurve(uint8_t sample)
+{
+    const uint8_t *table = g_transfer_curve_table;
+    
+    if (table == NULL)
+    {
+        return sample;
+    }
+    
+    return pgm_read_byte(&table[sample]);
+}
+#endif
+
+#if ENABLE_OUTPUT_SCALING
+uint8_t GetOutputDepth()
+{
+    return g_output_depth;
+}
+
+void SetOutputDepth(uint8_t depth)
+{
+    //
+    // 0xff is the full 0x00 - 0xff swing, and anything less squeezes the
+    // waveform towards the offset; 0x00 leaves it flat. Safe to call from an
+    // interrupt; the table itself is left for the main loop.
+    //
+    
+    if (depth != g_output_depth)
+    {
+        g_output_depth = depth;
+        
+#if ENABLE_WAVEFORM_MORPH
+        RebuildMorphTable();
+#else
+        RebuildOutputTable();
+#endif
+    }
+}
+
+uint8_t GetOutputOffset()
+{
+    return g_output_offset;
+}
+
+void SetOutputOffset(uint8_t offset)
+{
+    //
+    // Where the squeezed waveform sits within the full swing, 0x00 at the
+    // bottom and 0xff at the top; see UpdateOutputTable(). Has no effect at
+    // full depth.
+    //
+    
+    if (offset != g_output_offset)
+    {
+        g_output_offset = offset;
+        
+#if ENABLE_WAVEFORM_MORPH
+        RebuildMorphTable();
+#else
+        RebuildOutputTable();
+#endif
+    }
+}
+
+#if !ENABLE_WAVEFORM_MORPH
+void InitializeOutputTable()
+{
+    //
+    // The whole table in one go, for before the PWM interrupt starts reading
+    // from it.
+    //
+    
+    RebuildOutputTable();
+    
+    do
+    {
+        UpdateOutputTable();
+    }
+    while (g_output_entries_left > 0);
+}
+
+void UpdateOutputTable()
+{
+    uint16_t step;
+    uint16_t level;
+    uint8_t count;
+    
+    //
+    // Called from the main loop once per tick, and like UpdateMorphTable()
+    // rebuilds a few entries per call; a full rebuild takes 8 ticks. Each
+    // output level is
+    //
+    //   (offset * (256 - step) + sample * step) / 256, step = depth + 1
+    //
+    // i.e. the waveform is squeezed to step/256 of the full span, and the
+    // offset decides where within the remaining span it sits. It can never
+    // exceed 0xff, so no clipping is needed. The transfer curve, if
+    // included, goes on top as the final stage.
+    //
+    // There is no hardware multiplier on the attiny, so rather than
+    // multiplying per sample in the PWM interrupt the table is worked out
+    // here, with a single running sum from the first entry of each call.
+    //
+    
+    if (g_output_table_changed == 1)
+    {
+        g_output_table_changed = 0;
+        g_output_entries_left = OUTPUT_TABLE_SIZE;
+    }
+    
+    if (g_output_entries_left == 0)
+    {
+        return;
+    }
+    
+    step = (uint16_t)g_output_depth + 1;
+    level = ((uint16_t)g_output_offset * (0x100 - step)) + ((uint16_t)g_output_rebuild_index * step);
+    
+    for (count = 0; (count < OUTPUT_ENTRIES_PER_UPDATE) && (g_output_entries_left > 0); count++)
+    {
+#if ENABLE_TRANSFER_CURVE
+        g_output_table[g_output_rebuild_index] = ApplyTransferCurve(level >> 8);
+#else
+        g_output_table[g_output_rebuild_index] = level >> 8;
+#endif
+        
+        level += step;
+        g_output_rebuild_index++;
+        g_output_entries_left--;
+    }
+}
+
+void RebuildOutputTable()
+{
+    //
+    // For anything that goes into the table (depth, offset, transfer curve)
+    // having changed. A change arriving mid-rebuild starts the count over.
+    //
+    
+    g_output_table_changed = 1;
+}
+#endif
+#endif
+
+#if ENABLE_WAVEFORM_MORPH
+void InitializeMorphTable()
+{
+    //
+    // The whole table in one go, for before the PWM interrupt starts reading
+    // from it.
+    //
+    
+    RebuildMorphTable();
+    
+    do
+    {
+        UpdateMorphTable();
+    }
+    while (g_morph_entries_left > 0);
+}
+
+void UpdateMorphTable()
+{
+    uint16_t scaled_position;
+    uint8_t position;
+    uint8_t first_waveform;
+    uint8_t second_waveform;
+    uint8_t blend;
+    uint8_t count;
+    uint8_t sample;
+    uint8_t next_sample;
+    
+    //
+    // Called from the main loop once per tick. Rather than holding up the
+    // main loop with the whole table, each call rebuilds a few entries and
+    // leaves the rest for the next; a full rebuild takes 8 ticks. A change
+    // arriving mid-rebuild starts the count over, so every entry ends up
+    // reflecting the latest position.
+    //
+    // Note: The PWM interrupt keeps reading the table meanwhile, and will
+    //       see a mix of old and new entries for a few milliseconds. With
+    //       the position moving in small steps (potentiometer, encoder) that
+    //       can't be heard.
+    //
+    
+    if (g_morph_table_changed == 1)
+    {
+        g_morph_table_changed = 0;
+        g_morph_entries_left = MORPH_TABLE_SIZE;
+    }
+    
+    if (g_morph_entries_left == 0)
+    {
+        return;
+    }
+    
+    //
+    // The position is spread evenly over the gaps between the morph
+    // waveforms, and the top byte picks the pair while the low byte blends
+    // between them. The very top position is the last waveform as is, which
+    // a blend can't quite reach.
+    //
+    
+    position = g_morph_position;
+    
+    if (position == 0xff)
+    {
+        first_waveform = k_morph_waveforms[MORPH_WAVEFORM_COUNT - 1];
+        second_waveform = first_waveform;
+        blend = 0;
+    }
+    else
+    {
+        scaled_position = (uint16_t)position * (MORPH_WAVEFORM_COUNT - 1);
+        
+        first_waveform = k_morph_waveforms[scaled_position >> 8];
+        second_waveform = k_morph_waveforms[(scaled_position >> 8) + 1];
+        blend = scaled_position & 0xff;
+    }
+    
+    for (count = 0; (count < MORPH_ENTRIES_PER_UPDATE) && (g_morph_entries_left > 0); count++)
+    {
+        sample = CalculateSample(&g_oscillators[0], first_waveform, g_morph_rebuild_index, 0);
+        next_sample = CalculateSample(&g_oscillators[0], second_waveform, g_morph_rebuild_index, 0);
+        
+        if (next_sample >= sample)
+        {
+            sample += ScaleStep(next_sample - sample, blend);
+        }
+        else
+        {
+            sample -= ScaleStep(sample - next_sample, blend);
+        }
+        
+#if ENABLE_OUTPUT_SCALING
+        sample = ScaleOutput(sample);
+#endif
+#if ENABLE_TRANSFER_CURVE
+        sample = ApplyTransferCurve(sample);
+#endif
+        
+        g_morph_table[g_morph_rebuild_index] = sample;
+        
+        g_morph_rebuild_index++;
+        g_morph_entries_left--;
+    }
+}
+
+void RebuildMorphTable()
+{
+    //
+    // For anything else that goes into the table (depth, offset, transfer
+    // curve) having changed.
+    //
+    
+    g_morph_table_changed = 1;
+}
+
+uint8_t GetMorphPosition()
+{
+    return g_morph_position;
+}
+
+void SetMorphPosition(uint8_t position)
+{
+    //
+    // 0x00 is the first of the morph waveforms (sine), 0xff the last (ramp
+    // down), with the others spread evenly in between; see
+    // k_morph_waveforms. Safe to call from an interrupt; the table itself is
+    // left for the main loop.
+    //
+    
+    if (position != g_morph_position)
+    {
+        g_morph_position = position;
+        g_morph_table_changed = 1;
+    }
+}
+#endif
+#endif
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+void RecalculateTempo()
+{
+#if ENABLE_WAVEFORM_OUTPUT
+    uint8_t count;
+#endif
+    
+    //
+    // Recalculate the base duty cycle based on the new tempo.
+    //
+    
+#if ENABLE_SPEED_ADJUST
+    g_base_duty_cycle = CalculateBaseDutyCycle(g_base_tempo + g_tempo_adjust_offset);
+#else
+    g_base_duty_cycle = CalculateBaseDutyCycle(g_base_tempo);
+#endif
+    
+#if ENABLE_WAVEFORM_OUTPUT
+    //
+    // Then the working duty cycle of each oscillator, from its multiplier.
+    //
+    
+    for (count = 0; count < OSCILLATOR_COUNT; count++)
+    {
+        if (g_oscillators[count].is_active)
+        {
+            SetOscillatorTempo(&g_oscillators[count]);
+        }
+    }
+#endif
+}
+
+uint32_t CalculateBaseDutyCycle(uint16_t tempo)
+{
+    float new_frequency;
+    
+    //
+    // Convert the tempo from a millisecond count to a frequency, and then to
+    // the phase accumulator increment that produces it.
+    //
+    
+    new_frequency = (TEMPO_TO_FREQUENCY / (float)tempo);
+    
+    return new_frequency * DUTY_CYCLE_DIVISOR;
+}
+
+#if ENABLE_TEMPO_AVERAGING
+uint16_t CalculateAverageTempo(uint16_t tempo)
+{
+    static uint8_t index = 0;
+    uint8_t i;
+    
+    //
+    // Store the current tempo reading in the correct array spot and update
+    // the reading count if we haven't yet reached the maximum.
+    //
+    
+    if (g_average_tempo_count < TEMPO_AVERAGE_MAX_COUNT)
+    {
+        index = g_average_tempo_count;
+        g_average_tempo_count++;
+    }
+    
+    g_average_tempo[index] = tempo;
+    
+    //
+    // Update the array index making sure to wrap around the index if we reach
+    // the end. This way we always overwrite the oldest recorded tempo.
+    //
+    
+    index++;
+    if (index >= TEMPO_AVERAGE_MAX_COUNT)
+    {
+        index = 0;
+    }
+    
+    //
+    // Add up and divide by sample count to get a basic average tempo.
+    // Repurposing the input argument variable since we no longer need it. Note
+    // that average count will always be at least one at this point, so there's
+    // no risk dividing by zero.
+    //
+    
+    tempo = 0;
+    for (i = 0; i < g_average_tempo_count; i++)
+    {
+        tempo += g_average_tempo[i];
+    }
+    tempo = tempo / g_average_tempo_count;
+    
+    return tempo;
+}
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+void AlignOscillator(volatile lfo_oscillator *oscillator)
+{
+    //
+    // Before proceeding, make sure the index isn't out of bounds.
+    //
+    
+    if (oscillator->multiplier_alignment_index >= MULTIPLIER_ALIGNMENT_OFFSET)
+    {
+        oscillator->multiplier_alignment_index = 0;
+    }
+    
+    //
+    // Align the phase accumulator appropriately based on the waveform
+    // multiplier. Each multiplier aligns with the base tempo at different
+    // intervals.
+    //
+    
+    if ((oscillator->multiplier_alignment_index % k_multiplier_alignment[oscillator->multiplier]) == 0)
+    {
+        TRACE(TraceEventAlign, oscillator->phase_accumulator >> 16);
+        
+        oscillator->phase_accumulator = 0;
+    }
+    
+    oscillator->multiplier_alignment_index++;
+}
+
+uint8_t PlotSample(volatile lfo_oscillator *oscillator, uint8_t index)
+{
+#if !ENABLE_WAVEFORM_MORPH
+    uint8_t sample;
+#endif
+    
+    //
+    // Plot a single point on the oscillator's waveform, at the given index;
+    // see CalculateSample(). A morphed waveform is read straight from its
+    // table, which already has any output scaling and transfer curve
+    // applied.
+    //
+    
+#if ENABLE_WAVEFORM_MORPH
+    return g_morph_table[index];
+#else
+    sample = CalculateSample(oscillator, oscillator->waveform, index, (oscillator->phase_accumulator >> 16) & 0xff);
+    
+    //
+    // Pass the point through the output scaling table, if included, to apply
+    // depth and offset, and the transfer curve along with them. A single
+    // lookup regardless of the settings.
+    //
+    
+#if ENABLE_OUTPUT_SCALING
+    return g_output_table[sample];
+#elif ENABLE_TRANSFER_CURVE
+    return ApplyTransferCurve(sample);
+#else
+    return sample;
+#endif
+#endif
+}
+
+uint8_t CalculateSample(volatile lfo_oscillator *oscillator, uint8_t waveform, uint8_t index, uint8_t fraction)
+{
+    uint8_t sample;
+    
+    //
+    // Work out a single point on the given waveform, at the given 8-bit index
+    // into the cycle. The fraction is the next byte of the phase, for the
+    // shapes that can make use of it, and the oscillator is only needed for
+    // the random ones.
+    //
+    
+    switch (waveform)
+    {
+        case WaveformSine:
+        
+            //
+            // Drawing this one from a table; see ReadSineTable() and
+            // InterpolateSineTable().
+            //
+            
+#if ENABLE_SINE_INTERPOLATION
+            sample = InterpolateSineTable(index, fraction);
+#else
+            sample = ReadSineTable(index);
+#endif
+            break;
+        
+        case WaveformRampUp:
+        
+            //
+            //   /|  /|
+            //  / | / |
+            // /  |/  |
+            //
+            // Easily calculated; x = i
+            //
+            
+            sample = index;
+            break;
+        
+        case WaveformRampDown:
+        
+            //
+            // \  |\  |
+            //  \ | \ |
+            //   \|  \|
+            //
+            // Easily calculated; x = max - i
+            //
+            
+            sample = 0xff - index;
+            break;
+        
+        case WaveformTriangle:
+        
+            //
+            // \    /\    /
+            //  \  /  \  /
+            //   \/    \/
+            //
+            // Easily calculated; first half: x = 2i, second half: x = max - 2i
+            //
+            
+            if (index < 0x80)
+            {
+                sample = index * 2;
+            }
+            else
+            {
+                sample = 0xff - ((index - 0x80) * 2);
+            }
+            break;
+        
+        case WaveformSquare:
+        
+            //
+            // +-----+     |
+            // |     |     |
+            // |     +-----+
+            //
+            // Easily calculated; first half: x = min, second half: x = max
+            //
+            
+            if (index < 0x80)
+            {
+                sample = 0x00;
+            }
+            else
+            {
+                sample = 0xff;
+            }
+            break;
+        
+        case WaveformRandom:
+        
+            //
+            // Use whatever is the current random number. Make sure to change
+            // this number each complete waveform cycle.
+            //
+            
+            sample = oscillator->random_number;
+            break;
+        
+#if ENABLE_SMOOTH_RANDOM
+        case WaveformSmoothRandom:
+        case WaveformRandomWalk:
+        
+            //
+            // The level is moved along by RenderOscillatorSample(), and a
+            // new target picked each cycle; see StartRandomSegment().
+            //
+            
+            sample = oscillator->random_level >> 24;
+            break;
+#endif
+        
+#if ENABLE_CUSTOM_WAVEFORM
+        case WaveformCustom:
+        
+            //
+            // One lookup per sample, as the table is already expanded to
+            // the full phase index resolution; see LoadCustomWaveform().
+            //
+            
+            sample = g_custom_waveform[index];
+            break;
+#endif
+        
+        default:
+        
+            sample = 0x00;
+            break;
+    }
+    
+    return sample;
+}
+
+uint8_t ReadSineTable(uint8_t index)
+{
+#if WAVETABLE_SINE_QUARTER
+    uint8_t position;
+    uint8_t sample;
+#endif
+    
+    index >>= WAVEFORM_INDEX_SHIFT;
+    
+#if WAVETABLE_SINE_QUARTER
+    //
+    // Only the first quarter of the cycle is stored; see
+    // SINE_QUARTER_POSITION() in signaling.h.
+    //
+    
+    position = SINE_QUARTER_POSITION(index, WAVEFORM_RESOLUTION);
+    
+    sample = pgm_read_byte(&k_sine_table[position]);
+    
+    if (SINE_QUARTER_IS_INVERTED(index, WAVEFORM_RESOLUTION))
+    {
+        sample = WAVETABLE_MAX - sample;
+    }
+    
+    return sample;
+#else
+    return pgm_read_byte(&k_sine_table[index]);
+#endif
+}
+
+uint8_t NextRandomNumber()
+{
+    uint16_t state = g_random_state;
+    
+    //
+    // A 16-bit xorshift generator; three shifts and xors, cheap enough to run
+    // in the PWM interrupt, where the library rand() isn't. Repeats after
+    // 65535 numbers, which is plenty for an LFO.
+    //
+    
+    state ^= state << 7;
+    state ^= state >> 9;
+    state ^= state << 8;
+    
+    g_random_state = state;
+    
+    return state & 0xff;
+}
+
+uint8_t NextRandomStep()
+{
+    //
+    // A "random" level for the random waveform, one of a few fixed steps.
+    //
+    
+    return (NextRandomNumber() % WAVEFORM_RANDOM_STEP_COUNT) * WAVEFORM_STEP_SIZE;
+}
+
+#if ENABLE_SINE_INTERPOLATION
+uint8_t InterpolateSineTable(uint8_t index, uint8_t fraction)
+{
+    uint8_t position;
+    uint8_t sample;
+    uint8_t next_sample;
+    
+    //
+    // ReadSineTable() only goes by the top WAVETABLE_INDEX_BITS of the phase,
+    // so at slow tempos each entry is held for thousands of samples before
+    // the output steps to the next one. The bits below the table index (the
+    // rest of the 8-bit index, then the next byte of the phase accumulator)
+    // say how far along we are towards the next entry, 0 - 255, and the two
+    // entries are blended accordingly.
+    //
+    
+    position = (((uint16_t)index << 8) | fraction) >> WAVEFORM_INDEX_SHIFT;
+    
+    sample = ReadSineTable(index);
+    next_sample = ReadSineTable(index + (1 << WAVEFORM_INDEX_SHIFT));
+    
+    if (next_sample >= sample)
+    {
+        return sample + ScaleStep(next_sample - sample, position);
+    }
+    
+    return sample - ScaleStep(sample - next_sample, position);
+}
+#endif
+
+
+#if ENABLE_OUTPUT_SCALING && ENABLE_WAVEFORM_MORPH
+uint8_t ScaleOutput(uint8_t sample)
+{
+    uint16_t step;
+    
+    //
+    // A single output level, the same way UpdateOutputTable() works them
+    // out; for the morph table, which is only built a few entries at a time
+    // from the main loop, so the multiply is affordable.
+    //
+    
+    step = (uint16_t)g_output_depth + 1;
+    
+    return ((uint16_t)g_output_offset * (0x100 - step) + (uint16_t)sample * step) >> 8;
+}
+#endif
+
+#if ENABLE_SMOOTH_RANDOM
+void StartRandomSegment(volatile lfo_oscillator *oscillator)
+{
+    uint8_t level = oscillator->random_target;
+    int16_t target;
+    
+    //
+    // Called each time a cycle completes. The target for the cycle just
+    // completed is where the next one starts from, exactly, so rounding
+    // errors in the step can't pile up from one cycle to the next. The half
+    // step of rounding keeps the level away from the edge of its integer
+    // part (and the output from flickering between two values).
+    //
+    
+    oscillator->random_level = ((uint32_t)level << 24) + RANDOM_LEVEL_ROUNDING;
+    
+    //
+    // Smooth random picks any new level, whereas the random walk only moves
+    // a short random distance from the current one, bouncing back off either
+    // end of the range.
+    //
+    
+    if (oscillator->waveform == WaveformRandomWalk)
+    {
+        target = level + (NextRandomNumber() % RANDOM_WALK_STEP_RANGE) - (RANDOM_WALK_STEP_RANGE / 2);
+        
+        if (target < RANDOM_LEVEL_MIN)
+        {
+            target = (2 * RANDOM_LEVEL_MIN) - target;
+        }
+        else if (target > RANDOM_LEVEL_MAX)
+        {
+            target = (2 * RANDOM_LEVEL_MAX) - target;
+        }
+    }
+    else
+    {
+        target = NextRandomNumber();
+        
+        if (target < RANDOM_LEVEL_MIN)
+        {
+            target = RANDOM_LEVEL_MIN;
+        }
+        else if (target > RANDOM_LEVEL_MAX)
+        {
+            target = RANDOM_LEVEL_MAX;
+        }
+    }
+    
+    oscillator->random_target = target;
+    oscillator->random_delta = target - level;
+    oscillator->random_step = CalculateRandomStep(oscillator->duty_cycle, oscillator->random_delta);
+}
+
+uint32_t CalculateRandomStep(uint32_t duty_cycle, int16_t delta)
+{
+    uint32_t step = 0;
+    uint32_t addend = duty_cycle >> 8;
+    uint8_t distance = (delta < 0) ? -delta : delta;
+    
+    //
+    // The level has to cover delta (8.24 fixed point) in the number of
+    // samples a cycle takes, 2^32 / duty cycle, which makes the step per
+    // sample delta * duty cycle / 256. Shifts and adds, as in ScaleStep(),
+    // since this runs in the PWM interrupt; one round per bit of the
+    // distance, eight at the most, once per cycle. Rounds down, so the level
+    // falls short of the target rather than past it.
+    //
+    
+    while (distance != 0)
+    {
+        if (distance & 0x01)
+        {
+            step += addend;
+        }
+        
+        addend <<= 1;
+        distance >>= 1;
+    }
+    
+    return (delta < 0) ? -step : step;
+}
+#endif
+
+#if ENABLE_SKEW
+void RecalculateSkew(volatile lfo_oscillator *oscillator)
+{
+    uint32_t first_half_duty_cycle;
+    uint32_t second_half_duty_cycle;
+    
+    //
+    // Spend skew/256 of the cycle on the first half of the waveform, and the
+    // rest on the second half. Covering half the phase accumulator range in
+    // skew/256 of the time takes a step of duty cycle * 128 / skew, and
+    // likewise for the second half.
+    //
+    // Worked out once per tempo, multiplier or skew change so the PWM
+    // interrupt only has to pick one of the two. The floating point work is
+    // done with interrupts on, and only the 32-bit results are handed over
+    // atomically, since this may be called from the main loop.
+    //
+    
+    CalculateSkewDutyCycles(oscillator->duty_cycle, oscillator->skew, &first_half_duty_cycle, &second_half_duty_cycle);
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        oscillator->first_half_duty_cycle = first_half_duty_cycle;
+        oscillator->second_half_duty_cycle = second_half_duty_cycle;
+    }
+}
+
+void CalculateSkewDutyCycles(uint32_t duty_cycle, uint8_t skew, uint32_t *first_half_duty_cycle, uint32_t *second_half_duty_cycle)
+{
+    //
+    // Two floating point divisions; keep this out of the interrupts.
+    //
+    
+    *first_half_duty_cycle = duty_cycle * (128.0f / skew);
+    *second_half_duty_cycle = duty_cycle * (128.0f / (256 - skew));
+}
+#endif
+
+uint32_t CalculatePhaseAccumulator(uint32_t base_phase_accumulator, uint8_t multiplier, uint8_t alignment_index)
+{
+    //
+    // When the tempo multiplier has changed, the working phase accumulator
+    // also have to change to reflect how far the new duty cycle would have
+    // got had it been running from the start.
+    //
+    // By doing this the current tempo with multiplier will keep in sync with
+    // the base tempo.
+    //
+    // Note: For multipliers faster than 1:1 tempo the 32-bit working phase
+    //       accumulator will overflow and wrap around before the base one has
+    //       had a chance to do so. Fortunately, multiplying by the ratio to
+    //       get the new phase accumulator also overflows at 32 bits and the
+    //       end result is the same (at least it seems to work that way when
+    //       testing).
+    //
+    // Note 2: Because not all multipliers produce waveforms that align on
+    //         every base cycle, the multiplier alignemnt index also has to be
+    //         taken into account when finding the correct phase accumulator.
+    //         See AlignWaveform() for more details on this.
+    //
+    
+    return base_phase_accumulator * (k_multiplier_ratio[multiplier] * alignment_index);
+}
+
+uint8_t SettingsAreValid(const lfo_settings *settings)
+{
+    if ((settings->base_tempo > LFO_MIN_TEMPO) || (settings->base_tempo < LFO_MAX_TEMPO))
+    {
+        return 0;
+    }
+    
+#if ENABLE_SPEED_ADJUST
+    if (((settings->base_tempo + settings->tempo_adjust_offset) > LFO_MIN_TEMPO) ||
+        ((settings->base_tempo + settings->tempo_adjust_offset) < LFO_MAX_TEMPO))
+    {
+        return 0;
+    }
+#endif
+    
+    if ((settings->waveform >= WaveformCount) || (settings->multiplier >= MultiplierCount))
+    {
+        return 0;
+    }
+    
+#if ENABLE_SKEW
+    if ((settings->skew < SKEW_MIN) || (settings->skew > SKEW_MAX))
+    {
+        return 0;
+    }
+#endif
+    
+#if ENABLE_TRANSFER_CURVE
+    if (settings->transfer_curve >= TransferCurveCount)
+    {
+        return 0;
+    }
+#endif
+    
+    return 1;
+}
+#endif
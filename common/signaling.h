@@ -0,0 +1,460 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __SIGNALING_H__
+#define __SIGNALING_H__
+
+#include "board.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Feature flags. Each board turns on whatever it needs in its board.h; any
+// flag left undefined is off.
+//
+// ENABLE_WAVEFORM_OUTPUT .... LFO waveform generation on top of the base
+//                             tempo (needs wavetable.h).
+// ENABLE_SPEED_ADJUST ....... Speed adjustment offset on top of the tapped
+//                             tempo.
+// ENABLE_TEMPO_AVERAGING .... Average the tapped tempo over several taps.
+// ENABLE_TRIPLET_MULTIPLIER . Include the triplet multiplier.
+// ENABLE_SKEW ............... Movable waveform break point.
+// ENABLE_PHASE_OFFSET ....... Waveform phase offset relative to the base
+//                             tempo.
+// ENABLE_OUTPUT_SCALING ..... Output depth and offset, through an output
+//                             table (or the morph table); see
+//                             SetOutputDepth(). Takes a 256 byte table.
+// ENABLE_QUEUED_SETTINGS .... Settings changes applied at the next base
+//                             cycle boundary; see QueueSettings().
+// ENABLE_SINE_INTERPOLATION . Blend neighbouring sine table entries using
+//                             the phase below the table index.
+// ENABLE_WAVEFORM_MORPH ..... Continuous morph between neighbouring
+//                             waveforms in place of the discrete selection;
+//                             see SetMorphPosition(). Takes a 256 byte table.
+// ENABLE_SMOOTH_RANDOM ...... Smooth random and random walk waveforms; see
+//                             StartRandomSegment().
+// ENABLE_SECOND_OUTPUT ...... Second waveform output, phase locked to the
+//                             first at an offset (needs SECOND_OUTPUT_COMPARE
+//                             in board.h); see SetSecondOutputOffset().
+// ENABLE_CUSTOM_WAVEFORM .... User drawn waveform, stored in EEPROM (needs
+//                             customwave.h, and the SRAM of the morph or
+//                             output table); see LoadCustomWaveform().
+// ENABLE_TRANSFER_CURVE ..... Selectable transfer curve as the final output
+//                             stage (needs curves.h and customcurve.h); see
+//                             SelectTransferCurve().
+//
+
+#ifndef ENABLE_WAVEFORM_OUTPUT
+#define ENABLE_WAVEFORM_OUTPUT          0
+#endif
+
+#ifndef ENABLE_SPEED_ADJUST
+#define ENABLE_SPEED_ADJUST             0
+#endif
+
+#ifndef ENABLE_TEMPO_AVERAGING
+#define ENABLE_TEMPO_AVERAGING          0
+#endif
+
+#ifndef ENABLE_TRIPLET_MULTIPLIER
+#define ENABLE_TRIPLET_MULTIPLIER       0
+#endif
+
+#ifndef ENABLE_SKEW
+#define ENABLE_SKEW                     0
+#endif
+
+#ifndef ENABLE_PHASE_OFFSET
+#define ENABLE_PHASE_OFFSET             0
+#endif
+
+#ifndef ENABLE_OUTPUT_SCALING
+#define ENABLE_OUTPUT_SCALING           0
+#endif
+
+#ifndef ENABLE_QUEUED_SETTINGS
+#define ENABLE_QUEUED_SETTINGS          0
+#endif
+
+#ifndef ENABLE_SINE_INTERPOLATION
+#define ENABLE_SINE_INTERPOLATION       0
+#endif
+
+#ifndef ENABLE_WAVEFORM_MORPH
+#define ENABLE_WAVEFORM_MORPH           0
+#endif
+
+#ifndef ENABLE_SMOOTH_RANDOM
+#define ENABLE_SMOOTH_RANDOM            0
+#endif
+
+#ifndef ENABLE_SECOND_OUTPUT
+#define ENABLE_SECOND_OUTPUT            0
+#endif
+
+#ifndef ENABLE_CUSTOM_WAVEFORM
+#define ENABLE_CUSTOM_WAVEFORM          0
+#endif
+
+#ifndef ENABLE_TRANSFER_CURVE
+#define ENABLE_TRANSFER_CURVE           0
+#endif
+
+//
+// Board hooks, for the pins that follow the tempo counting and the waveform.
+// Defined in board.h where needed.
+//
+
+#ifndef TEMPO_COUNT_STARTED
+#define TEMPO_COUNT_STARTED()
+#endif
+
+#ifndef TEMPO_COUNT_STOPPED
+#define TEMPO_COUNT_STOPPED()
+#endif
+
+#ifndef TEMPO_COUNT_TIMED_OUT
+#define TEMPO_COUNT_TIMED_OUT()
+#endif
+
+#ifndef WAVEFORM_CYCLE_COMPLETED
+#define WAVEFORM_CYCLE_COMPLETED()
+#endif
+
+//
+// Attribute for the PWM interrupt handler. With the speed profile (see
+// profiles.mk) everything it calls is inlined into it, saving the call
+// overhead and register pushes at 31.25kHz; the size profile leaves that up
+// to the compiler.
+//
+
+#if OPTIMIZE_FOR_SPEED
+#define ISR_FLATTEN                     __attribute__((flatten))
+#else
+#define ISR_FLATTEN
+#endif
+
+//
+// Quarter wave sine tables (WAVETABLE_SINE_QUARTER in wavetable.h) only
+// store the first quarter of a cycle of N entries, plus the peak. The second
+// quarter is the first one mirrored, and the second half is the first half
+// turned upside down:
+//
+//   0    - N/4  : table[i]
+//   N/4  - N/2  : max - table[N/2 - i]
+//   N/2  - 3N/4 : max - table[i - N/2]
+//   3N/4 - N    : table[N - i]
+//
+// SINE_QUARTER_POSITION() folds a table index onto the stored quarter, and
+// SINE_QUARTER_IS_INVERTED() tells whether the entry read there is to be
+// turned upside down, with a single unsigned compare. Used by the LFO
+// boards and the tap-tempo clock's LFO channels alike, whatever the depth
+// of their tables.
+//
+
+#define SINE_QUARTER_POSITION(index, resolution) \
+    ((((index) & (((resolution) / 2) - 1)) > ((resolution) / 4)) ? \
+        (((resolution) / 2) - ((index) & (((resolution) / 2) - 1))) : \
+        ((index) & (((resolution) / 2) - 1)))
+    
+#define SINE_QUARTER_IS_INVERTED(index, resolution) \
+    ((uint8_t)(((index) - ((resolution) / 4) - 1) & ((resolution) - 1)) < (((resolution) / 2) - 1))
+
+//
+// In milliseconds = 0.1Hz, 10 seconds
+//
+
+#define LFO_MIN_TEMPO           		10000
+
+//
+// In milliseconds = 20Hz, 5/100ths of a second
+//
+
+#define LFO_MAX_TEMPO           		50
+
+#if ENABLE_WAVEFORM_OUTPUT
+//
+// Available waveforms.
+//
+
+typedef enum
+{
+    WaveformSine = 0,
+    WaveformRampUp,
+    WaveformRampDown,
+    WaveformTriangle,
+    WaveformSquare,
+    WaveformRandom,
+#if ENABLE_SMOOTH_RANDOM
+    WaveformSmoothRandom,
+    WaveformRandomWalk,
+#endif
+#if ENABLE_CUSTOM_WAVEFORM
+    WaveformCustom,
+#endif
+    WaveformCount           // Dummy entry to get the enum count.
+} Waveform;
+
+#if ENABLE_TRANSFER_CURVE
+//
+// Available transfer curves, for the output level; linear (as is),
+// exponential, logarithmic or the custom one in customcurve.h.
+//
+
+typedef enum
+{
+    TransferCurveLinear = 0,
+    TransferCurveExponential,
+    TransferCurveLogarithmic,
+    TransferCurveCustom,
+    TransferCurveCount      // Dummy entry to get the enum count.
+} TransferCurve;
+#endif
+
+//
+// Available tempo multipliers.
+//
+
+typedef enum
+{
+    MultiplierWhole = 0,
+    MultiplierDottedHalf,
+    MultiplierHalf,
+    MultiplierDottedQuarter,
+    MultiplierQuarter,
+    MultiplierDottedEighth,
+    MultiplierEighth,
+    MultiplierDottedSixteenth,
+#if ENABLE_TRIPLET_MULTIPLIER
+    MultiplierTriplet,
+#endif
+    MultiplierSixteenth,
+    MultiplierCount         // Dummy entry to get the enum count.
+} Multiplier;
+
+//
+// Number of waveform oscillators, all running off the same base tempo; see
+// lfo_oscillator. Only the first one is running to begin with, and the rest
+// are started with InitializeOscillator(). A board with more than one LFO
+// output sets this in its board.h.
+//
+
+#ifndef OSCILLATOR_COUNT
+#define OSCILLATOR_COUNT                1
+#endif
+
+//
+// A single waveform oscillator; its own waveform, multiplier and phase
+// accumulator, plus whatever the enabled features keep per waveform. The
+// selection functions and the settings take the oscillator number
+// (SelectOscillatorWaveform(), GetOscillatorSettings() etc.), and the plain
+// ones (SelectWaveform(), GetSettings() etc.) go by the first one, as does
+// the waveform cycle hook.
+//
+
+typedef struct
+{
+    uint32_t phase_accumulator;
+    uint32_t duty_cycle;
+    uint8_t table_index;
+    uint8_t waveform;
+    uint8_t multiplier;
+    uint8_t multiplier_alignment_index;
+    uint8_t random_number;                  // Used with the "random" waveform.
+#if ENABLE_SKEW
+    uint8_t skew;
+    uint32_t first_half_duty_cycle;
+    uint32_t second_half_duty_cycle;
+#endif
+#if ENABLE_PHASE_OFFSET
+    uint8_t phase_offset;
+#endif
+#if ENABLE_SMOOTH_RANDOM
+    uint32_t random_level;
+    uint32_t random_step;
+    int16_t random_delta;
+    uint8_t random_target;
+#endif
+    volatile uint8_t *output_compare;       // PWM compare register to write to.
+    uint8_t is_active;
+} lfo_oscillator;
+
+#if ENABLE_SECOND_OUTPUT
+//
+// Default phase offset of the second output; 90 degrees (quadrature). The
+// full 8-bit value covers a full cycle.
+//
+
+#define SECOND_OUTPUT_DEFAULT_OFFSET    0x40
+#endif
+
+#if ENABLE_OUTPUT_SCALING
+//
+// Default output scaling; full depth, centered (which only matters once the
+// depth is turned down).
+//
+
+#define OUTPUT_DEFAULT_DEPTH            0xff
+#define OUTPUT_DEFAULT_OFFSET           0x80
+#endif
+
+#if ENABLE_CUSTOM_WAVEFORM
+//
+// The custom waveform is drawn with CUSTOM_WAVEFORM_POINTS levels over the
+// cycle, kept in a record at the very end of the EEPROM, out of the way of
+// anything placed there by the linker. The record is only used if the CRC
+// (as by _crc16_update(), seeded with CUSTOM_WAVEFORM_CRC_SEED) checks out;
+// see LoadCustomWaveform() and tools/customwave.c.
+//
+
+#define CUSTOM_WAVEFORM_POINTS          64
+#define CUSTOM_WAVEFORM_CRC_SEED        0xffff
+
+typedef struct
+{
+    uint8_t points[CUSTOM_WAVEFORM_POINTS];
+    uint16_t crc;
+} custom_waveform_record;
+
+#define CUSTOM_WAVEFORM_EEPROM_ADDRESS  ((E2END + 1) - sizeof(custom_waveform_record))
+#endif
+
+//
+// Snapshot of the user settings, for anything that needs to keep them
+// somewhere and put them back later.
+//
+
+typedef struct
+{
+    uint16_t base_tempo;
+#if ENABLE_SPEED_ADJUST
+    int16_t tempo_adjust_offset;
+#endif
+    uint8_t waveform;
+    uint8_t multiplier;
+#if ENABLE_WAVEFORM_MORPH
+    uint8_t morph_position;
+#endif
+#if ENABLE_SKEW
+    uint8_t skew;
+#endif
+#if ENABLE_SECOND_OUTPUT
+    uint8_t second_output_offset;
+#endif
+#if ENABLE_TRANSFER_CURVE
+    uint8_t transfer_curve;
+#endif
+#if ENABLE_OUTPUT_SCALING
+    uint8_t output_depth;
+    uint8_t output_offset;
+#endif
+} lfo_settings;
+#endif
+
+//
+// Public function prototypes.
+//
+
+void SetBaseTempo(uint16_t milliseconds);
+void StartTempoCount();
+void StopTempoCount();
+void TempoCountTimeout();
+void ResetBaseTempo();
+uint8_t ScaleStep(uint8_t step, uint8_t fraction);
+
+#if ENABLE_SPEED_ADJUST
+void AdjustSpeed(int16_t change_value);
+void ResetSpeedAdjustSetting();
+void ModifySpeedAdjust(int8_t change_value);
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+void ResetSignals();
+void GetSettings(lfo_settings *settings);
+void GetOscillatorSettings(uint8_t number, lfo_settings *settings);
+void ApplySettings(const lfo_settings *settings);
+void ApplyOscillatorSettings(uint8_t number, const lfo_settings *settings);
+uint8_t QueueSettings(const lfo_settings *settings);
+uint8_t QueueOscillatorSettings(uint8_t number, const lfo_settings *settings);
+void ApplyQueuedSettings();
+
+void SeedRandomNumberGenerator(uint32_t seed);
+void UpdateRandomNumber();
+void PlotWaveform();
+void AlignWaveform();
+void InitializeOscillator(uint8_t number, volatile uint8_t *output_compare);
+void SetOscillatorTempo(volatile lfo_oscillator *oscillator);
+uint8_t RenderOscillatorSample(volatile lfo_oscillator *oscillator);
+void SelectOscillatorWaveform(uint8_t number, uint8_t waveform);
+void SelectOscillatorMultiplier(uint8_t number, uint8_t multiplier);
+uint8_t GetWaveform();
+void SelectWaveform(uint8_t waveform);
+uint8_t GetMultiplier();
+void SelectMultiplier(uint8_t multiplier);
+uint8_t GetSkew();
+void SetSkew(uint8_t value);
+void SetOscillatorSkew(uint8_t number, uint8_t value);
+void SetPhaseOffset(uint8_t value);
+void SetOscillatorPhaseOffset(uint8_t number, uint8_t value);
+
+#if ENABLE_SECOND_OUTPUT
+uint8_t GetSecondOutputOffset();
+void SetSecondOutputOffset(uint8_t value);
+#endif
+
+#if ENABLE_CUSTOM_WAVEFORM
+uint8_t LoadCustomWaveform();
+#endif
+
+#if ENABLE_TRANSFER_CURVE
+uint8_t GetTransferCurve();
+void SelectTransferCurve(uint8_t curve);
+uint8_t ApplyTransferCurve(uint8_t sample);
+#endif
+
+#if ENABLE_OUTPUT_SCALING
+uint8_t GetOutputDepth();
+void SetOutputDepth(uint8_t depth);
+uint8_t GetOutputOffset();
+void SetOutputOffset(uint8_t offset);
+
+#if !ENABLE_WAVEFORM_MORPH
+void InitializeOutputTable();
+void UpdateOutputTable();
+void RebuildOutputTable();
+#endif
+#endif
+
+#if ENABLE_WAVEFORM_MORPH
+void InitializeMorphTable();
+void UpdateMorphTable();
+void RebuildMorphTable();
+uint8_t GetMorphPosition();
+void SetMorphPosition(uint8_t position);
+#endif
+#endif
+
+#endif // __SIGNALING_H__
@@ -0,0 +1,268 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Note: The watchdog is only fed when both the 1ms tick interrupt and the
+//       main loop have checked in since the last time. The tick only checks
+//       in if the PWM interrupt has been running at (close to) the expected
+//       rate. This way an interrupt storm (e.g. a bad sync cable), a main
+//       loop stuck with interrupts disabled, or a starved PWM interrupt all
+//       end up resetting the chip.
+//
+//       The last known settings are kept in a block of SRAM that isn't
+//       cleared on startup (.noinit), and are picked up again after anything
+//       but a power-on reset.
+//
+
+#include <avr/io.h>
+#include <avr/wdt.h>
+
+#include "board.h"
+#include "signaling.h"
+#include "critical.h"
+#include "supervision.h"
+
+//
+// Defines and structs.
+//
+
+#define RECOVERY_SIGNATURE              0xa5
+
+typedef struct
+{
+    uint8_t signature;
+    lfo_settings settings;
+    uint8_t checksum;
+} recovery_block;
+
+//
+// Reset cause counters, for diagnostics. Each saturates at 0xff.
+//
+
+typedef struct
+{
+    uint8_t power_on;
+    uint8_t external;
+    uint8_t brown_out;
+    uint8_t watchdog;
+} reset_counters;
+
+//
+// Local function prototypes.
+//
+
+void CaptureResetCause() __attribute__((naked, used, section(".init3")));
+uint8_t CalculateRecoveryChecksum();
+void CountReset(volatile uint8_t *counter);
+
+//
+// Global variables.
+//
+
+volatile recovery_block g_recovery __attribute__((section(".noinit")));
+volatile reset_counters g_reset_counters __attribute__((section(".noinit")));
+volatile uint8_t g_reset_cause __attribute__((section(".noinit")));
+
+volatile uint8_t g_supervision_sample_count;
+volatile uint8_t g_has_tick_checked_in;
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializeSupervision()
+{
+    //
+    // Count the reset that just happened. The counters live in .noinit as
+    // well, so they're only trustworthy after anything but a power-on reset.
+    //
+    
+    if (g_reset_cause & (1 << PORF))
+    {
+        g_reset_counters.power_on = 0;
+        g_reset_counters.external = 0;
+        g_reset_counters.brown_out = 0;
+        g_reset_counters.watchdog = 0;
+        
+        CountReset(&g_reset_counters.power_on);
+    }
+    else
+    {
+        if (g_reset_cause & (1 << EXTRF))
+        {
+            CountReset(&g_reset_counters.external);
+        }
+        
+        if (g_reset_cause & (1 << BORF))
+        {
+            CountReset(&g_reset_counters.brown_out);
+        }
+        
+        if (g_reset_cause & (1 << WDRF))
+        {
+            CountReset(&g_reset_counters.watchdog);
+        }
+    }
+    
+    g_supervision_sample_count = 0;
+    g_has_tick_checked_in = 0;
+    
+    wdt_enable(SUPERVISION_TIMEOUT);
+}
+
+void SuperviseTick()
+{
+    //
+    // Called from the 1ms tick interrupt. Check in, as long as the PWM
+    // interrupt has kept up since the last tick.
+    //
+    
+    if (g_supervision_sample_count >= SUPERVISION_MIN_SAMPLE_COUNT)
+    {
+        g_has_tick_checked_in = 1;
+    }
+    
+    g_supervision_sample_count = 0;
+}
+
+void SuperviseMainLoop()
+{
+    //
+    // Called once per main loop iteration. Getting here is the main loop's
+    // check-in, so feed the watchdog if the tick has checked in too.
+    //
+    
+    if (g_has_tick_checked_in == 1)
+    {
+        g_has_tick_checked_in = 0;
+        
+        wdt_reset();
+    }
+    
+    //
+    // Keep the recovery block up to date with the current settings.
+    //
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        GetSettings((lfo_settings *)&g_recovery.settings);
+    }
+    
+    g_recovery.signature = RECOVERY_SIGNATURE;
+    g_recovery.checksum = CalculateRecoveryChecksum();
+}
+
+void SuspendSupervision()
+{
+    //
+    // Nothing will be checking in while powered down.
+    //
+    
+    wdt_disable();
+}
+
+void ResumeSupervision()
+{
+    g_supervision_sample_count = 0;
+    g_has_tick_checked_in = 0;
+    
+    wdt_enable(SUPERVISION_TIMEOUT);
+}
+
+uint8_t RecoverSettings()
+{
+    //
+    // Put back the settings from before the reset, if there are any to be
+    // had. The block is garbage after a power-on reset, and the checksum
+    // catches it if it got corrupted some other way. ApplySettings() does
+    // its own bounds checking on top of that.
+    //
+    
+    if (g_reset_cause & (1 << PORF))
+    {
+        return 0;
+    }
+    
+    if ((g_recovery.signature != RECOVERY_SIGNATURE) || (g_recovery.checksum != CalculateRecoveryChecksum()))
+    {
+        return 0;
+    }
+    
+    ApplySettings((const lfo_settings *)&g_recovery.settings);
+    
+    return 1;
+}
+
+uint8_t GetResetCause()
+{
+    //
+    // MCUSR as it was at startup; see CaptureResetCause().
+    //
+    
+    return g_reset_cause;
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+void CaptureResetCause()
+{
+    //
+    // Runs before main(), and before .data and .bss are set up. After a
+    // watchdog reset the watchdog is still running (at its shortest timeout),
+    // so it has to be turned off as early as possible. WDRF has to be cleared
+    // before the watchdog can be disabled.
+    //
+    
+    g_reset_cause = MCUSR;
+    MCUSR = 0x00;
+    
+    wdt_disable();
+}
+
+uint8_t CalculateRecoveryChecksum()
+{
+    uint8_t count;
+    uint8_t checksum = RECOVERY_SIGNATURE;
+    volatile uint8_t *data = (volatile uint8_t *)&g_recovery.settings;
+    
+    //
+    // Simple rotate-and-add checksum; enough to tell random power-on SRAM
+    // contents from a valid block.
+    //
+    
+    for (count = 0; count < sizeof(lfo_settings); count++)
+    {
+        checksum = ((checksum << 1) | (checksum >> 7)) + data[count];
+    }
+    
+    return checksum;
+}
+
+void CountReset(volatile uint8_t *counter)
+{
+    if (*counter < 0xff)
+    {
+        (*counter)++;
+    }
+}
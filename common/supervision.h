@@ -1,5 +1,5 @@
 //
-// Tap-tempo LFO for 8-bit AVR.
+// Tap-tempo LFO and clock for 8-bit AVR.
 // 
 // Copyright (C) 2013-2016 Harald Sabro
 // 
@@ -22,44 +22,38 @@
 // Email: harald (AT) website 
 //
 
-#ifndef __SIGNALING_H__
-#define __SIGNALING_H__
+#ifndef __SUPERVISION_H__
+#define __SUPERVISION_H__
 
 //
 // Defines and structs.
 //
 
 //
-// In milliseconds = 0.1Hz, 10 seconds
+// Watchdog timeout. Generous compared to the 1ms main loop, but short enough
+// that a stalled LFO is back up before anyone notices.
 //
 
-#define LFO_MIN_TEMPO           		10000
+#define SUPERVISION_TIMEOUT             WDTO_120MS
 
 //
-// In milliseconds = 20Hz, 5/100ths of a second
+// Minimum number of PWM interrupts per 1ms tick for the tick to check in.
+// Nominally there are 31.25 of them, so this leaves plenty of margin while
+// still catching a PWM interrupt that's being starved by an interrupt storm.
 //
 
-#define LFO_MAX_TEMPO           		50
+#define SUPERVISION_MIN_SAMPLE_COUNT    16
 
 //
 // Public function prototypes.
 //
 
-void SetBaseTempo(uint16_t milliseconds);
-void StartTempoCount();
-void StopTempoCount();
-void TempoCountTimeout();
-void ResetSignals();
+void InitializeSupervision();
+void SuperviseTick();
+void SuperviseMainLoop();
+void SuspendSupervision();
+void ResumeSupervision();
+uint8_t RecoverSettings();
+uint8_t GetResetCause();
 
-void SeedRandomNumberGenerator(uint32_t seed);
-void UpdateRandomNumber();
-void PlotWaveform();
-void AlignWaveform();
-void AdjustSpeed(int16_t change_value);
-void ResetSpeedAdjustSetting();
-void SetWaveform(int8_t change_value);
-void ResetWaveformSetting();
-void SetMultiplier(int8_t change_value);
-void ResetMultiplierSetting();
-
-#endif // __SIGNALING_H__
+#endif // __SUPERVISION_H__
@@ -1,5 +1,5 @@
 //
-// Tap-tempo LFO for 8-bit AVR.
+// Tap-tempo LFO and clock for 8-bit AVR.
 // 
 // Copyright (C) 2013-2016 Harald Sabro
 // 
@@ -24,8 +24,7 @@
 
 #include <avr/io.h>
 
-#include "main.h"
-#include "signaling.h"
+#include "board.h"
 #include "switching.h"
 
 //
@@ -79,15 +78,15 @@ void InitializeSwitching()
 void DebounceSwitches()
 {
 	static uint8_t switch_state_index = 0;
-	
+
 	//
-	// Get the current state of all PA pins and store them at whatever state
-    // index we're currently at, making sure to reset the state index whenever
-    // we go past the max count.
+	// Get the current state of all switch port pins (SWITCH_PIN) and store
+    // them at whatever state index we're currently at, making sure to reset
+    // the state index whenever we go past the max count.
 	//
-	
-	g_switch_samples[switch_state_index] = PINB;
-	
+
+	g_switch_samples[switch_state_index] = SWITCH_PIN;
+
 	switch_state_index++;
 	if (switch_state_index >= DEBOUNCE_CHECK_COUNT)
 	{
@@ -111,28 +110,51 @@ void CalculateSwitchStates()
     // more reading on a particular pin reads "open" that debounce state bit
     // will be cleared. And the opposite for open state.
 	//
-	
+
 	for (count = 0; count < DEBOUNCE_CHECK_COUNT; count++)
 	{
 		accumulated_closed_switch_state |= g_switch_samples[count];
         accumulated_open_switch_state &= g_switch_samples[count];
 	}
-    
+
     //
     // Store the new switch states, and set the corresponding changed bit
     // for each switch that changed state since last time.
     //
-	
+
 	previous_closed_switch_state = g_closed_switch_state;
     previous_open_switch_state = g_open_switch_state;
-    
+
 	g_closed_switch_state = accumulated_closed_switch_state;
     g_open_switch_state = accumulated_open_switch_state;
-	
+    
     g_closed_switch_state_changed = g_closed_switch_state ^ previous_closed_switch_state;
     g_open_switch_state_changed = g_open_switch_state ^ previous_open_switch_state;
 }
 
+void ResumeSwitching()
+{
+    uint8_t count;
+    uint8_t switch_state = SWITCH_PIN;
+    
+    //
+    // Start over from whatever state the switches are in right now, without
+    // flagging any state changes. Used when waking from standby, so the
+    // switch press that woke us isn't also taken as a tap or mode change.
+    //
+    
+    for (count = 0; count < DEBOUNCE_CHECK_COUNT; count++)
+    {
+        g_switch_samples[count] = switch_state;
+    }
+    
+    g_closed_switch_state = switch_state;
+    g_open_switch_state = switch_state;
+    
+    g_closed_switch_state_changed = 0x00;
+    g_open_switch_state_changed = 0x00;
+}
+
 uint8_t SwitchWasClosed(uint8_t pins)
 {
     //
@@ -152,3 +174,13 @@ uint8_t SwitchWasOpened(uint8_t pins)
     
     return (g_open_switch_state & g_open_switch_state_changed) & pins;
 }
+
+uint8_t SwitchIsClosed(uint8_t pins)
+{
+    //
+    // Return the last calculated closed switch state, regardless of whether
+    // it just changed, filtered on the requested pin(s).
+    //
+    
+    return ~g_closed_switch_state & pins;
+}
@@ -1,5 +1,5 @@
 //
-// Tap-tempo LFO for 8-bit AVR.
+// Tap-tempo LFO and clock for 8-bit AVR.
 // 
 // Copyright (C) 2013-2016 Harald Sabro
 // 
@@ -32,7 +32,9 @@
 void InitializeSwitching();
 void DebounceSwitches();
 void CalculateSwitchStates();
+void ResumeSwitching();
 uint8_t SwitchWasClosed(uint8_t pins);
 uint8_t SwitchWasOpened(uint8_t pins);
+uint8_t SwitchIsClosed(uint8_t pins);
 
 #endif // __SWITCHING_H__
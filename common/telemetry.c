@@ -0,0 +1,271 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#include "board.h"
+#include "signaling.h"
+#include "critical.h"
+#include "telemetry.h"
+#include "trace.h"
+
+#if ENABLE_TELEMETRY
+
+//
+// Defines and structs.
+//
+
+//
+// Bits per byte on the line: start bit, 8 data bits (LSB first), stop bit.
+//
+
+#define TELEMETRY_BIT_COUNT             10
+
+//
+// Local function prototypes.
+//
+
+void FillStatusFrame(uint8_t *frame);
+#if ENABLE_TRACE
+void FillTraceFrame(uint8_t *frame, uint8_t position);
+#endif
+void PutWord(uint8_t *frame, uint16_t value);
+void PutLong(uint8_t *frame, uint32_t value);
+
+//
+// Global variables.
+//
+
+volatile uint8_t g_telemetry_frame[TELEMETRY_FRAME_SIZE];
+volatile uint8_t g_telemetry_byte_index;
+volatile uint8_t g_telemetry_bit_index;
+volatile uint8_t g_is_transmitting_telemetry;
+
+//
+// Signaling state; see signaling.c.
+//
+
+extern volatile uint16_t g_base_tempo;
+extern volatile uint32_t g_base_duty_cycle;
+extern volatile uint8_t g_base_table_index;
+extern volatile int16_t g_sync_error;
+
+#if ENABLE_SPEED_ADJUST
+extern volatile int16_t g_tempo_adjust_offset;
+#endif
+
+#if ENABLE_WAVEFORM_OUTPUT
+extern volatile lfo_oscillator g_oscillators[OSCILLATOR_COUNT];
+#endif
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializeTelemetry()
+{
+    //
+    // Idle high until there's something to send.
+    //
+    
+    TELEMETRY_PORT |= (1 << TELEMETRY_OUT);
+    TELEMETRY_DDR |= (1 << TELEMETRY_OUT);
+}
+
+void TransmitTelemetry()
+{
+    uint8_t bit_index = g_telemetry_bit_index;
+    
+    //
+    // Called from the 1ms tick interrupt. Puts exactly one bit on the line
+    // per tick, so the cost per tick is the same whatever is being sent.
+    //
+    
+    if (g_is_transmitting_telemetry == 0)
+    {
+        return;
+    }
+    
+    if (bit_index == 0)
+    {
+        TELEMETRY_PORT &= ~(1 << TELEMETRY_OUT);    // Start bit.
+    }
+    else if ((bit_index == (TELEMETRY_BIT_COUNT - 1)) ||
+             (g_telemetry_frame[g_telemetry_byte_index] & (1 << (bit_index - 1))))
+    {
+        TELEMETRY_PORT |= (1 << TELEMETRY_OUT);     // Stop bit or data 1.
+    }
+    else
+    {
+        TELEMETRY_PORT &= ~(1 << TELEMETRY_OUT);
+    }
+    
+    if (++bit_index < TELEMETRY_BIT_COUNT)
+    {
+        g_telemetry_bit_index = bit_index;
+        
+        return;
+    }
+    
+    g_telemetry_bit_index = 0;
+    
+    if (++g_telemetry_byte_index >= TELEMETRY_FRAME_SIZE)
+    {
+        g_telemetry_byte_index = 0;
+        g_is_transmitting_telemetry = 0;
+    }
+}
+
+void UpdateTelemetry()
+{
+    static uint8_t sequence = 0;
+#if ENABLE_TRACE
+    static uint8_t trace_position = 0;
+#endif
+    uint8_t *frame = (uint8_t *)g_telemetry_frame;
+    uint8_t checksum = TELEMETRY_CHECKSUM_SEED;
+    uint8_t count;
+    
+    //
+    // Called from the main loop. The frame belongs to the tick interrupt
+    // until it's been sent.
+    //
+    
+    if (g_is_transmitting_telemetry == 1)
+    {
+        return;
+    }
+    
+    frame[1] = sequence++;
+    
+#if ENABLE_TRACE
+    //
+    // The trace goes out first, right after startup, while it still holds
+    // whatever led up to the reset. Recording is held off until it's all
+    // been copied out.
+    //
+    
+    if (trace_position < TRACE_LENGTH)
+    {
+        HoldTrace(1);
+        FillTraceFrame(frame, trace_position);
+        
+        trace_position += TELEMETRY_TRACE_RECORDS;
+        if (trace_position >= TRACE_LENGTH)
+        {
+            HoldTrace(0);
+        }
+    }
+    else
+#endif
+    {
+        FillStatusFrame(frame);
+    }
+    
+    for (count = 0; count < (TELEMETRY_FRAME_SIZE - 1); count++)
+    {
+        checksum = ((checksum << 1) | (checksum >> 7)) + frame[count];
+    }
+    frame[TELEMETRY_FRAME_SIZE - 1] = checksum;
+    
+    g_is_transmitting_telemetry = 1;
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+void FillStatusFrame(uint8_t *frame)
+{
+    frame[0] = TELEMETRY_SYNC;
+    
+    //
+    // Take a consistent snapshot of anything the interrupts may be changing
+    // halfway through.
+    //
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        PutWord(&frame[2], g_base_tempo);
+#if ENABLE_SPEED_ADJUST
+        PutWord(&frame[4], g_tempo_adjust_offset);
+#else
+        PutWord(&frame[4], 0);
+#endif
+        PutLong(&frame[6], g_base_duty_cycle);
+        frame[14] = g_base_table_index;
+#if ENABLE_WAVEFORM_OUTPUT
+        PutLong(&frame[10], g_oscillators[0].duty_cycle);
+        frame[15] = g_oscillators[0].table_index;
+#else
+        PutLong(&frame[10], g_base_duty_cycle);
+        frame[15] = g_base_table_index;
+#endif
+        PutWord(&frame[18], g_sync_error);
+        PutWord(&frame[20], g_late_sample_count);
+        PutWord(&frame[22], g_missed_sample_count);
+    }
+    
+#if ENABLE_WAVEFORM_OUTPUT
+    frame[16] = GetWaveform();
+    frame[17] = GetMultiplier();
+#else
+    frame[16] = 0xff;
+    frame[17] = 0xff;
+#endif
+}
+
+#if ENABLE_TRACE
+void FillTraceFrame(uint8_t *frame, uint8_t position)
+{
+    trace_record record;
+    uint8_t count;
+    
+    frame[0] = TELEMETRY_TRACE_SYNC;
+    frame[2] = position;
+    frame[23] = TRACE_LENGTH;
+    
+    for (count = 0; count < TELEMETRY_TRACE_RECORDS; count++)
+    {
+        GetTraceRecord(position + count, &record);
+        
+        PutWord(&frame[3 + (count * 5)], record.time);
+        frame[5 + (count * 5)] = record.event;
+        PutWord(&frame[6 + (count * 5)], record.value);
+    }
+}
+#endif
+
+void PutWord(uint8_t *frame, uint16_t value)
+{
+    frame[0] = value & 0xff;
+    frame[1] = value >> 8;
+}
+
+void PutLong(uint8_t *frame, uint32_t value)
+{
+    PutWord(&frame[0], value & 0xffff);
+    PutWord(&frame[2], value >> 16);
+}
+
+#endif // ENABLE_TELEMETRY
@@ -0,0 +1,99 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include "board.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Telemetry output. Off unless turned on from the Makefile. Each board.h
+// points TELEMETRY_PORT, TELEMETRY_DDR and TELEMETRY_OUT at a spare pin.
+//
+// The pin is a transmit-only serial line, 1000 baud 8N1 (idle high), driven
+// one bit per 1ms tick from the tick interrupt; i.e. a fixed and very small
+// share of each tick, so it can't disturb the PWM interrupt. The main loop
+// fills in a frame whenever the previous one is done, so frames go out
+// back to back, about four per second.
+//
+// Frame layout, multi-byte fields little-endian:
+//
+//   0       TELEMETRY_SYNC
+//   1       Sequence number, incremented per frame
+//   2 - 3   Base tempo (ms)
+//   4 - 5   Speed adjust offset (ms, signed)
+//   6 - 9   Base tempo phase increment
+//   10 - 13 Output phase increment (multiplied tempo)
+//   14      Base tempo phase (top byte of the accumulator)
+//   15      Output phase
+//   16      Waveform
+//   17      Multiplier
+//   18 - 19 Sync lock error; last tempo count minus the tempo that was
+//           running at the time (ms, signed)
+//   20 - 21 Late PWM samples (see critical.h)
+//   22 - 23 Missed PWM samples
+//   24      Checksum of bytes 0 - 23; starting from TELEMETRY_CHECKSUM_SEED,
+//           rotate left by one and add the next byte
+//
+// Fields a board doesn't have (e.g. waveform on the clock) are sent as 0xff
+// bytes, or 0 for the speed adjust offset.
+//
+// With the trace on as well (see trace.h), the trace is sent first at
+// startup, TELEMETRY_TRACE_RECORDS events per frame, oldest first:
+//
+//   0       TELEMETRY_TRACE_SYNC
+//   1       Sequence number
+//   2       Position in the trace of the first event in the frame
+//   3 - 22  Events; time stamp (ms, 2 bytes), event, value (2 bytes)
+//   23      Trace length
+//   24      Checksum, as above
+//
+// See tools/telemetry.c for a decoder.
+//
+
+#ifndef ENABLE_TELEMETRY
+#define ENABLE_TELEMETRY                0
+#endif
+
+#define TELEMETRY_SYNC                  0xa5
+#define TELEMETRY_TRACE_SYNC            0xa6
+#define TELEMETRY_CHECKSUM_SEED         0x5a
+#define TELEMETRY_FRAME_SIZE            25
+#define TELEMETRY_TRACE_RECORDS         4
+
+//
+// Public function prototypes.
+//
+
+#if ENABLE_TELEMETRY
+void InitializeTelemetry();
+void TransmitTelemetry();
+void UpdateTelemetry();
+#endif
+
+#endif // __TELEMETRY_H__
@@ -0,0 +1,118 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#include "board.h"
+#include "trace.h"
+
+#if ENABLE_TRACE
+
+//
+// Global variables.
+//
+
+volatile trace_buffer g_trace __attribute__((section(".noinit")));
+volatile uint8_t g_is_trace_held;
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializeTrace(uint8_t reset_cause)
+{
+    uint8_t count;
+    
+    //
+    // Start over after a power-on reset, or if the buffer doesn't look like
+    // one (e.g. the very first time).
+    //
+    
+    if ((reset_cause & (1 << PORF)) ||
+        (g_trace.signature != TRACE_SIGNATURE) ||
+        (g_trace.next_index >= TRACE_LENGTH))
+    {
+        for (count = 0; count < TRACE_LENGTH; count++)
+        {
+            g_trace.records[count].event = TraceEventNone;
+        }
+        
+        g_trace.next_index = 0;
+        g_trace.time = 0;
+        g_trace.signature = TRACE_SIGNATURE;
+    }
+    
+    g_is_trace_held = 0;
+    
+    RecordTraceEvent(TraceEventReset, reset_cause);
+}
+
+void RecordTraceEvent(uint8_t event, uint16_t value)
+{
+    volatile trace_record *record;
+    
+    if (g_is_trace_held == 1)
+    {
+        return;
+    }
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        record = &g_trace.records[g_trace.next_index];
+        record->time = g_trace.time;
+        record->event = event;
+        record->value = value;
+        
+        g_trace.next_index = (g_trace.next_index + 1) & (TRACE_LENGTH - 1);
+    }
+}
+
+void HoldTrace(uint8_t is_held)
+{
+    //
+    // Stop recording while the trace is being read out, so the events being
+    // read aren't overwritten halfway through.
+    //
+    
+    g_is_trace_held = is_held;
+}
+
+void GetTraceRecord(uint8_t position, trace_record *record)
+{
+    volatile trace_record *source;
+    
+    //
+    // Oldest first; position 0 is the oldest event still kept.
+    //
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        source = &g_trace.records[(g_trace.next_index + position) & (TRACE_LENGTH - 1)];
+        record->time = source->time;
+        record->event = source->event;
+        record->value = source->value;
+    }
+}
+
+#endif // ENABLE_TRACE
@@ -0,0 +1,118 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include "board.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Event trace. Off unless turned on from the Makefile.
+//
+// The last TRACE_LENGTH events (taps, sync edges, tempo changes, phase
+// resets etc.) are kept in a ring buffer in .noinit RAM, along with a
+// millisecond time stamp. Neither is cleared by a watchdog or external reset,
+// only by a power-on reset, so after a glitch has reset the unit the events
+// leading up to it are still there. With telemetry on as well, the whole
+// trace is sent at startup, before the regular telemetry frames (see
+// telemetry.h); otherwise g_trace can be read with a debugger.
+//
+// Recording an event is a few stores with interrupts disabled, so it's safe
+// to do from the interrupt handlers.
+//
+
+#ifndef ENABLE_TRACE
+#define ENABLE_TRACE                    0
+#endif
+
+//
+// Number of events kept. Has to be a power of two, and at least 4 (one
+// telemetry frame's worth).
+//
+
+#ifndef TRACE_LENGTH
+#define TRACE_LENGTH                    32
+#endif
+
+#define TRACE_SIGNATURE                 0x7ace
+
+//
+// Traced events, and what's recorded as the event value.
+//
+
+typedef enum
+{
+    TraceEventNone = 0,             // Unused slot.
+    TraceEventReset,                // Reset cause (MCUSR) at startup.
+    TraceEventTap,                  // Tap switch pressed; 0.
+    TraceEventSync,                 // Sync input edge; the new pin level.
+    TraceEventTempo,                // SetBaseTempo(); the requested tempo.
+    TraceEventBaseReset,            // Base phase reset; top 16 bits before.
+    TraceEventAlign,                // Output phase reset; top 16 bits before.
+    TraceEventMode,                 // Selection mode/input source change.
+    TraceEventOverrun,              // Missed PWM sample; missed count.
+    TraceEventCount                 // Dummy entry to get the enum count.
+} TraceEvent;
+
+typedef struct
+{
+    uint16_t time;                  // ms, wraps after about a minute.
+    uint8_t event;
+    uint16_t value;
+} trace_record;
+
+typedef struct
+{
+    uint16_t signature;
+    uint16_t time;
+    uint8_t next_index;             // Where the next event goes; the oldest.
+    trace_record records[TRACE_LENGTH];
+} trace_buffer;
+
+#if ENABLE_TRACE
+#define TRACE(event, value)             RecordTraceEvent((event), (value))
+#define TRACE_TICK()                    g_trace.time++
+
+extern volatile trace_buffer g_trace;
+#else
+#define TRACE(event, value)
+#define TRACE_TICK()
+#endif
+
+//
+// Public function prototypes.
+//
+
+#if ENABLE_TRACE
+void InitializeTrace(uint8_t reset_cause);
+void RecordTraceEvent(uint8_t event, uint16_t value);
+void HoldTrace(uint8_t is_held);
+void GetTraceRecord(uint8_t position, trace_record *record);
+#endif
+
+#endif // __TRACE_H__
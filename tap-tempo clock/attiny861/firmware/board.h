@@ -0,0 +1,126 @@
+//
+// Tap-tempo clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+//
+// Board glue for the shared tap-tempo core (see common/). Selects the core
+// features this board uses, and hooks its pins into the tempo counting.
+//
+
+#include <avr/io.h>
+
+#include "main.h"
+
+//
+// Core features. No waveform output on the clock; just the base tempo.
+//
+
+#define ENABLE_SPEED_ADJUST             1
+#define ENABLE_TEMPO_AVERAGING          1
+
+//
+// LFO outputs on Timer1; see lfo.h and the Makefile. With any of them in use
+// Timer1 counts to 10 bits instead of 8, and the PWM interrupt (and with it
+// the base phase accumulator) runs at 8MHz / 1024 = 7.8125kHz.
+//
+
+#ifndef LFO_CHANNELS
+#define LFO_CHANNELS                    0
+#endif
+
+#if (LFO_CHANNELS < 0) || (LFO_CHANNELS > 3)
+#error "LFO_CHANNELS must be 0 - 3"
+#endif
+
+#if LFO_CHANNELS > 0
+#if ENABLE_TELEMETRY
+#error "LFO channel 1 (OC1B) and telemetry both use PB3; turn one of them off"
+#endif
+
+#define PWM_RESOLUTION                  1024
+#define CRITICAL_PWM_PERIOD             1024
+#define PWM_LATE_THRESHOLD              512
+
+#define LFO_1_COMPARE                   OCR1B
+#define LFO_2_COMPARE                   OCR1A
+#define LFO_3_COMPARE                   OCR1D
+#endif
+
+//
+// Tap averaging only applies to tapped tempo, not an external clock.
+//
+
+#define TEMPO_AVERAGING_IS_ACTIVE()     ((g_state.is_clock_input_source == 0) && (g_state.is_averaging_tempo == 1))
+
+//
+// Core hooks. The "tap input registration active" indicator LED is turned
+// off whenever the tempo counting ends, in case it's on.
+//
+
+#define SWITCH_PIN                      PINA
+#if LFO_CHANNELS > 0
+#define PWM_TIMER_COUNT                 ReadPwmTimerCount()
+#else
+#define PWM_TIMER_COUNT                 TCNT1
+#endif
+#define PWM_TIMER_OVERFLOW_PENDING()    (TIFR & (1 << TOV1))
+#define TELEMETRY_PORT                  PORTB
+#define TELEMETRY_DDR                   DDRB
+
+#define TEMPO_COUNT_STARTED()           PORTB &= ~((1 << SYNC_OUT) | (1 << SYNC_2X_OUT))
+#define TEMPO_COUNT_STOPPED()           PORTB = (PORTB & ~(1 << SYNC_2X_OUT)) | (1 << SYNC_OUT) | (1 << TAP_ACTIVE_OUT)
+#define TEMPO_COUNT_TIMED_OUT()         PORTB |= (1 << TAP_ACTIVE_OUT)
+
+//
+// Millisecond count before a speed adjust reset switch depress is
+// interpreted as a reset.
+//
+
+#define SPEED_ADJUST_RESET_MIN_TIME     2000
+
+#if LFO_CHANNELS > 0
+//
+// The 10-bit timer count. Reading TCNT1 latches the top two bits into TC1H,
+// so the low byte has to be read first.
+//
+
+static inline uint16_t ReadPwmTimerCount()
+{
+    uint8_t count = TCNT1;
+    
+    return ((uint16_t)TC1H << 8) | count;
+}
+#endif
+
+//
+// Shared state, defined in main.c.
+//
+
+extern volatile state_flags g_state;
+extern volatile uint16_t g_tempo_ms_count;
+
+#endif // __BOARD_H__
@@ -0,0 +1,227 @@
+//
+// Tap-tempo clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+#include "board.h"
+#include "signaling.h"
+#include "lfo.h"
+
+#if LFO_CHANNELS > 0
+
+#include "wavetable.h"
+
+//
+// Defines and structs.
+//
+
+#if WAVETABLE_DEPTH_BITS != 10
+#error "WAVETABLE_DEPTH_BITS must be 10 to match the Timer1 PWM; regenerate wavetable.h"
+#endif
+
+#if WAVETABLE_INDEX_BITS != 8
+#error "WAVETABLE_INDEX_BITS must be 8; regenerate wavetable.h"
+#endif
+
+#define WAVEFORM_RESOLUTION             (1 << WAVETABLE_INDEX_BITS)
+
+//
+// Local function prototypes.
+//
+
+uint16_t CalculateLfoSample(uint8_t waveform, uint16_t phase);
+uint16_t InterpolateSineTable(uint8_t index, uint8_t fraction);
+uint16_t ReadSineTable(uint8_t index);
+
+//
+// Global variables.
+//
+
+volatile lfo_channel g_lfo_channels[LFO_CHANNELS] =
+{
+    {
+        .phase_offset = LFO_CHANNEL_1_PHASE,
+        .waveform = LFO_CHANNEL_1_WAVEFORM,
+        .output_compare = &LFO_1_COMPARE,
+    },
+#if LFO_CHANNELS >= 2
+    {
+        .phase_offset = LFO_CHANNEL_2_PHASE,
+        .waveform = LFO_CHANNEL_2_WAVEFORM,
+        .output_compare = &LFO_2_COMPARE,
+    },
+#endif
+#if LFO_CHANNELS >= 3
+    {
+        .phase_offset = LFO_CHANNEL_3_PHASE,
+        .waveform = LFO_CHANNEL_3_WAVEFORM,
+        .output_compare = &LFO_3_COMPARE,
+    },
+#endif
+};
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void SetLfoChannel(uint8_t channel, uint8_t waveform, uint16_t phase_offset)
+{
+    if ((channel >= LFO_CHANNELS) || (waveform >= LfoWaveformCount))
+    {
+        return;
+    }
+    
+    //
+    // The phase offset is 16 bits, and read by the PWM interrupt.
+    //
+    
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        g_lfo_channels[channel].waveform = waveform;
+        g_lfo_channels[channel].phase_offset = phase_offset;
+    }
+}
+
+void PlotLfoChannels(uint32_t phase_accumulator)
+{
+    uint16_t phase = phase_accumulator >> 16;
+    uint16_t sample;
+    uint8_t channel;
+    
+    //
+    // Called from the PWM interrupt, once per Timer1 period. The compare
+    // registers are buffered and only take the new value at the top of the
+    // count, so there's the whole period to get them written.
+    //
+    // Note: The 10-bit compare registers are written through TC1H, which is
+    //       shared between them all (and TCNT1); the high bits have to go in
+    //       right before each low byte.
+    //
+    
+    for (channel = 0; channel < LFO_CHANNELS; channel++)
+    {
+        sample = CalculateLfoSample(g_lfo_channels[channel].waveform, phase + g_lfo_channels[channel].phase_offset);
+        
+        TC1H = sample >> 8;
+        *g_lfo_channels[channel].output_compare = sample & 0xff;
+    }
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+uint16_t CalculateLfoSample(uint8_t waveform, uint16_t phase)
+{
+    //
+    // Same shapes, and same phase, as the waveforms on the LFO boards (see
+    // CalculateSample() in signaling.c), only 10 bits deep. The top 10 bits
+    // of the 16-bit phase give the ramps one step per PWM level; the sine
+    // table only has 256 steps per cycle, so it's interpolated in between.
+    //
+    // Note: This doesn't go through the oscillators in signaling.c. They're
+    //       8 bits all the way through (tables, samples and the Timer0
+    //       compare registers they write to), and only built with
+    //       ENABLE_WAVEFORM_OUTPUT, which would also bring in the settings,
+    //       multipliers, skew and random waveforms the clock has no use for.
+    //       Widening them to 10 bits would slow down the PWM interrupt on the
+    //       LFO boards, so the few shapes needed here are worked out directly
+    //       from the base phase instead.
+    //
+    
+    switch (waveform)
+    {
+        case LfoWaveformRampUp:
+        
+            return phase >> 6;
+        
+        case LfoWaveformRampDown:
+        
+            return LFO_SAMPLE_MAX - (phase >> 6);
+        
+        case LfoWaveformTriangle:
+        
+            if (phase < 0x8000)
+            {
+                return phase >> 5;
+            }
+            return (0xffff - phase) >> 5;
+        
+        case LfoWaveformSquare:
+        
+            return (phase < 0x8000) ? 0 : LFO_SAMPLE_MAX;
+        
+        case LfoWaveformSine:
+        default:
+        
+            return InterpolateSineTable(phase >> 8, phase & 0xff);
+    }
+}
+
+uint16_t InterpolateSineTable(uint8_t index, uint8_t fraction)
+{
+    uint16_t sample = ReadSineTable(index);
+    uint16_t next_sample = ReadSineTable(index + 1);
+    
+    //
+    // Straight line between two neighbouring table entries. Adjacent entries
+    // are at most 13 apart at 10 bits, so the difference fits a byte either
+    // way, and is scaled without a multiply; see ScaleStep() in signaling.c.
+    //
+    
+    if (next_sample >= sample)
+    {
+        return sample + ScaleStep(next_sample - sample, fraction);
+    }
+    
+    return sample - ScaleStep(sample - next_sample, fraction);
+}
+
+uint16_t ReadSineTable(uint8_t index)
+{
+#if WAVETABLE_SINE_QUARTER
+    uint8_t position;
+    uint16_t sample;
+    
+    //
+    // Only the first quarter of the cycle is stored; see
+    // SINE_QUARTER_POSITION() in signaling.h.
+    //
+    
+    position = SINE_QUARTER_POSITION(index, WAVEFORM_RESOLUTION);
+    
+    sample = pgm_read_word(&k_sine_table[position]);
+    
+    if (SINE_QUARTER_IS_INVERTED(index, WAVEFORM_RESOLUTION))
+    {
+        sample = WAVETABLE_MAX - sample;
+    }
+    
+    return sample;
+#else
+    return pgm_read_word(&k_sine_table[index]);
+#endif
+}
+
+#endif // LFO_CHANNELS > 0
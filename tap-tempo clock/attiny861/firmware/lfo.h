@@ -0,0 +1,103 @@
+//
+// Tap-tempo clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __LFO_H__
+#define __LFO_H__
+
+//
+// Defines and structs.
+//
+
+//
+// Up to three 10-bit PWM LFO outputs on Timer1 (see LFO_CHANNELS in the
+// Makefile), all running off the base phase accumulator, i.e. at the same
+// rate as, and locked to, SYNC_OUT. Each channel has its own waveform and a
+// phase offset against the base tempo.
+//
+// Channel 1 is OC1B, channel 2 OC1A and channel 3 OC1D; see main.h for the
+// pins they take over.
+//
+
+#define LFO_SAMPLE_MAX                  WAVETABLE_MAX
+
+//
+// Default channel setup; evenly spread sines, i.e. quadrature with two
+// channels and three-phase with three. The phase offsets are in 1/65536 of
+// a cycle. Can be overridden from the Makefile, or changed at run time with
+// SetLfoChannel().
+//
+
+#ifndef LFO_CHANNEL_1_WAVEFORM
+#define LFO_CHANNEL_1_WAVEFORM          LfoWaveformSine
+#endif
+
+#ifndef LFO_CHANNEL_2_WAVEFORM
+#define LFO_CHANNEL_2_WAVEFORM          LfoWaveformSine
+#endif
+
+#ifndef LFO_CHANNEL_3_WAVEFORM
+#define LFO_CHANNEL_3_WAVEFORM          LfoWaveformSine
+#endif
+
+#ifndef LFO_CHANNEL_1_PHASE
+#define LFO_CHANNEL_1_PHASE             0x0000
+#endif
+
+#ifndef LFO_CHANNEL_2_PHASE
+#if LFO_CHANNELS == 2
+#define LFO_CHANNEL_2_PHASE             0x4000  /* 90 degrees */
+#else
+#define LFO_CHANNEL_2_PHASE             0x5555  /* 120 degrees */
+#endif
+#endif
+
+#ifndef LFO_CHANNEL_3_PHASE
+#define LFO_CHANNEL_3_PHASE             0xaaab  /* 240 degrees */
+#endif
+
+typedef enum
+{
+    LfoWaveformSine = 0,
+    LfoWaveformRampUp,
+    LfoWaveformRampDown,
+    LfoWaveformTriangle,
+    LfoWaveformSquare,
+    LfoWaveformCount        // Dummy entry to get the enum count.
+} LfoWaveform;
+
+typedef struct
+{
+    uint16_t phase_offset;
+    uint8_t waveform;
+    volatile uint8_t *output_compare;   // Low byte of the 10-bit compare.
+} lfo_channel;
+
+//
+// Public function prototypes.
+//
+
+void SetLfoChannel(uint8_t channel, uint8_t waveform, uint16_t phase_offset);
+void PlotLfoChannels(uint32_t phase_accumulator);
+
+#endif // __LFO_H__
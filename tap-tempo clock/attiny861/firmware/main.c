@@ -38,10 +38,15 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#include <util/atomic.h>
 
 #include "switching.h"
+#include "encoder.h"
 #include "signaling.h"
+#include "critical.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "power.h"
+#include "lfo.h"
 #include "main.h"
 
 //
@@ -73,6 +78,7 @@
 //
 
 volatile state_flags g_state;
+volatile uint8_t g_has_pending_tick;
 
 volatile uint16_t g_tempo_ms_count;
 volatile uint16_t g_speed_adjust_reset_ms_count;
@@ -101,6 +107,12 @@ int main()
     
     DDRA = 0x00;
     DDRB = (1 << SYNC_OUT) | (1 << SYNC_2X_OUT) | (1 << TAP_ACTIVE_OUT);
+#if LFO_CHANNELS >= 1
+    DDRB |= (1 << LFO_1_OUT);
+#endif
+#if LFO_CHANNELS >= 3
+    DDRB |= (1 << LFO_3_OUT);
+#endif
     
     //
     // Enable pull-up resistors on input pins and drive output pins high.
@@ -109,6 +121,17 @@ int main()
     PORTA = 0xff;
     PORTB = 0xff;
     
+#if ENABLE_TRACE
+    //
+    // Pick up the event trace from before the reset, if it survived. Nothing
+    // else looks at the reset cause on this board, so clear it for the next
+    // one.
+    //
+    
+    InitializeTrace(MCUSR);
+    MCUSR = 0x00;
+#endif
+    
     //
     // Initialize switching.
     //
@@ -127,6 +150,20 @@ int main()
     
     PRR = (1 << PRUSI) | (1 << PRADC);
     
+#if ENABLE_TELEMETRY
+    //
+    // Set up the telemetry output pin.
+    //
+    
+    InitializeTelemetry();
+#endif
+    
+    //
+    // Set up idle sleep for the main loop.
+    //
+    
+    InitializePower();
+    
     //
     // Set up Timer0 to trigger an interrupt every 1ms.
     // This timer is used to trigger the tap switch sampling routine.
@@ -151,7 +188,29 @@ int main()
     // This timer is used to generate the LFO PWM output signal.
     //
     
+#if LFO_CHANNELS > 0
+    //
+    // With the LFO outputs the timer counts to 10 bits (TOP = OCR1C, the top
+    // two bits through TC1H), and each channel gets its compare output. Note
+    // that the COM1A/COM1B bits are shadowed in TCCR1C, so they go in there
+    // as well or the TCCR1C write clears them.
+    //
+    
+    TC1H = 0x03;
+    OCR1C = 0xff;                           // TOP = 0x3ff.
+#if LFO_CHANNELS >= 2
+    TCCR1A = (1 << PWM1A) | (1 << COM1A1) | (1 << PWM1B) | (1 << COM1B1);
+    TCCR1C = (1 << COM1A1S) | (1 << COM1B1S);
+#else
+    TCCR1A = (1 << PWM1B) | (1 << COM1B1);
+    TCCR1C = (1 << COM1B1S);
+#endif
+#if LFO_CHANNELS >= 3
+    TCCR1C |= (1 << PWM1D) | (1 << COM1D1);
+#endif
+#else
     TCCR1A = (1 << PWM1B) | (1 << COM1B1);  // Enable PWM-mode on OCR1B. Clear on compare match.
+#endif
     TCCR1B = (1 << CS10);                   // No prescaler.
     TCCR1D = 0x00;                          // WGM11:10 = 00 enables Fast PWM.
     TIMSK |= (1 << TOIE1);                  // Timer1 overflow interrupt.
@@ -188,7 +247,23 @@ int main()
     while (1)
     {
         //
-        // Continuously poll the tap input switch.
+        // Sleep until the next 1ms tick; see SleepUntilNextTick().
+        //
+        
+        SleepUntilNextTick();
+        
+#if ENABLE_TELEMETRY
+        //
+        // Queue up the next telemetry frame once the last one is out.
+        //
+        
+        UpdateTelemetry();
+#endif
+        
+        //
+        // Poll the tap input switch, once per tick. The switch samples are
+        // only updated by the tick interrupt, so there's nothing new to find
+        // in between and no tap latency added by sleeping.
         //
         // Note: This routine has been moved to the main loop so as not to
         //       delay the interrupt processing unnecessarily. There is enough
@@ -214,9 +289,11 @@ int main()
             // switch.
             //
             
+            TRACE(TraceEventTap, 0);
+            
             if (g_state.is_clock_input_source == 0)
             {
-                ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+                PROFILED_ATOMIC_BLOCK(CriticalSectionTap)
                 {
                     //
                     // Always reset the output signal on a manual tap.
@@ -393,18 +470,42 @@ ISR(TIMER0_COMPA_vect)
     {
         g_speed_adjust_ms_count++;
     }
+    
+#if ENABLE_TRACE
+    //
+    // Keep the trace time stamps going.
+    //
+    
+    TRACE_TICK();
+#endif
+    
+#if ENABLE_TELEMETRY
+    //
+    // Next telemetry bit out.
+    //
+    
+    TransmitTelemetry();
+#endif
+    
+    //
+    // Let the main loop know there's a new tick to deal with.
+    //
+    
+    g_has_pending_tick = 1;
 }
 
 //
 // Timer1 overflow interrupt handler. This is where the LFO signal is
 // generated.
-// Frequency: 31.25kHz
+// Frequency: 31.25kHz (7.8125kHz with the 10-bit LFO outputs)
 //
 
-ISR(TIMER1_OVF_vect)
+ISR(TIMER1_OVF_vect, ISR_FLATTEN)
 {
     uint8_t previous_base_table_index = g_base_table_index;
     
+    PWM_INTERRUPT_ENTERED();
+    
     //
     // Increase the phase accumulator by a given amount based on the required
     // output signal frequency. Then use the high 8 bits (0-255) of the phase
@@ -426,6 +527,14 @@ ISR(TIMER1_OVF_vect)
     g_base_phase_accumulator += g_base_duty_cycle;
     g_base_table_index = (g_base_phase_accumulator & 0xff000000) >> 24;
     
+#if LFO_CHANNELS > 0
+    //
+    // The LFO outputs follow the base tempo, each at its own phase offset.
+    //
+    
+    PlotLfoChannels(g_base_phase_accumulator);
+    
+#endif
     //
     // Flag whenever there's an overflow in the base table index, i.e. the base
     // tempo, has just completed a full cycle.
@@ -460,6 +569,8 @@ ISR(TIMER1_OVF_vect)
     {
         PORTB ^= (1 << SYNC_2X_OUT);
     }
+    
+    PWM_INTERRUPT_LEAVING();
 }
 
 //
@@ -468,14 +579,12 @@ ISR(TIMER1_OVF_vect)
 
 ISR(PCINT_vect)
 {
-    static const int8_t encoder_table[16] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
-    static uint8_t encoder_samples = 3;
-    static int8_t encoder_value = 0;
     static uint8_t previous_interrupt_a = 0x00;
     static uint8_t previous_interrupt_b = 0x00;
     
     uint8_t interrupt_a = PINA;
     uint8_t interrupt_b = PINB;
+    int8_t change_value;
     
     //
     // Check for rotary encoder pin change interrupts.
@@ -488,38 +597,10 @@ ISR(PCINT_vect)
         // One or more rotary encoder pins have changed since last time. 
         //
         
-        //
-        // Keep sampling the four latest rotary states, as pairs of bits, in a
-        // shift register. Make room for the next sample (and discard the
-        // oldest one).
-        //
-        
-        encoder_samples <<= 2;
-        
-        //
-        // Since the current rotary samples need to be added to the shift
-        // register at the start, and they do not necessarily align pin-wise,
-        // they must be adjusted accordingly.
-        //
-        
-        encoder_samples |= ((interrupt_a & (1 << ROTARY_A_IN)) >> ROTARY_A_IN) | ((interrupt_a & (1 << ROTARY_B_IN)) >> (ROTARY_B_IN - 1));
-        
-        //
-        // Update the encoder value and check the result.
-        //
-        
-        encoder_value += encoder_table[(encoder_samples & 0x0f)];
-        if (encoder_value > 3)
+        change_value = DecodeEncoder(interrupt_a);
+        if (change_value != 0)
         {
-            ModifySpeedAdjust(1);
-            
-            encoder_value = 0;
-        }
-        else if (encoder_value < -3)
-        {
-            ModifySpeedAdjust(-1);
-            
-            encoder_value = 0;
+            ModifySpeedAdjust(change_value);
         }
     }
     
@@ -530,6 +611,8 @@ ISR(PCINT_vect)
     if ((interrupt_a & (1 << INPUT_SELECT_IN)) != (previous_interrupt_a & (1 << INPUT_SELECT_IN)))
     {
         g_state.is_clock_input_source = ((interrupt_a & (1 << INPUT_SELECT_IN)) == 0) ? 1 : 0;
+        
+        TRACE(TraceEventMode, g_state.is_clock_input_source);
 
         //
         // We have a change in the input source selection. If we were in the
@@ -563,6 +646,8 @@ ISR(PCINT_vect)
     
     if ((interrupt_a & (1 << SYNC_IN)) != (previous_interrupt_a & (1 << SYNC_IN)))
     {
+        TRACE(TraceEventSync, ((interrupt_a & (1 << SYNC_IN)) != 0));
+        
         //
         // Honor the input selection by only proceeding if clock input is
         // selected the source.
@@ -47,16 +47,33 @@
 #define SYNC_OUT                		PB0     /* Tempo indicator / sync output */
 #define SYNC_2X_OUT                     PB1     /* Sync 2x output */
 #define TAP_ACTIVE_OUT                  PB2     /* LED indicator when actively counting tempo */
-#define UNUSED1                         PB3
+#define TELEMETRY_OUT                   PB3     /* Telemetry serial output (spare pin) */
 #define CRYSTAL_IN1                     PB4     /* Crystal leg #1 */
 #define CRYSTAL_IN2                     PB5     /* Crystal leg #2 */
 #define TAP_AVERAGING_IN                PB6     /* Accumulate tap inputs, and average */
 #define RESET                   		PB7     /* Reset */
 
+//
+// LFO outputs (see lfo.h and LFO_CHANNELS in the Makefile). These take over
+// pins from above: channel 1 the spare telemetry pin, channel 2 the sync 2x
+// output, and channel 3 the second crystal leg, which means running off the
+// internal oscillator instead (see the Makefile). The timer drives the pins
+// directly, so anything written to SYNC_2X_OUT in PORTB goes nowhere.
+//
+
+#define LFO_1_OUT                       PB3     /* LFO channel 1 output (OC1B) */
+#define LFO_2_OUT                       PB1     /* LFO channel 2 output (OC1A) */
+#define LFO_3_OUT                       PB5     /* LFO channel 3 output (OC1D) */
+
 //
 // Various boolean flags wrapped up in a single byte to save space (not sure if
 // actually ends up taking less space when compiled).
 //
+// Note: The main loop updates these with a read-modify-write of the whole
+//       byte, not always inside an atomic block. The tick flag is set from the
+//       timer interrupt on every tick, so it's kept apart (g_has_pending_tick
+//       in main.c) rather than risk a tick being lost.
+//
 
 typedef struct
 {
@@ -67,7 +84,6 @@ typedef struct
     uint8_t is_2x_clock_input:1;
     uint8_t is_averaging_tempo:1;
     uint8_t is_counting_2x_tempo:1;
-    uint8_t reserved:1;
 } state_flags;
 
 #endif // __MAIN_H__
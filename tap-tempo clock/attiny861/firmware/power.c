@@ -0,0 +1,79 @@
+//
+// Tap-tempo clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "main.h"
+#include "power.h"
+
+//
+// Global variables.
+//
+
+extern volatile uint8_t g_has_pending_tick;
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializePower()
+{
+    //
+    // Idle sleep only stops the CPU (and flash) clock. The timers, and with
+    // them the PWM output and the 1ms tick, keep running, and any interrupt
+    // wakes the CPU back up.
+    //
+    
+    set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+void SleepUntilNextTick()
+{
+    //
+    // Sleep until the 1ms timer interrupt has flagged a new tick. The PWM
+    // interrupt (and any pin change) will also wake the CPU, so keep going
+    // back to sleep until it's actually the tick.
+    //
+    // Note: Interrupts are kept disabled while checking the flag. The
+    //       instruction following sei() is always executed before any pending
+    //       interrupt, so a tick arriving between the check and sleep_cpu()
+    //       will wake us right back up rather than being slept through.
+    //
+    
+    cli();
+    
+    while (g_has_pending_tick == 0)
+    {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        cli();
+    }
+    
+    g_has_pending_tick = 0;
+    
+    sei();
+}
@@ -22,25 +22,14 @@
 // Email: harald (AT) website 
 //
 
-#ifndef __SWITCHING_H__
-#define __SWITCHING_H__
-
-//
-// Millisecond count before a mode switch depress is interpreted as a reset.
-//
-
-#define SPEED_ADJUST_RESET_MIN_TIME         2000
+#ifndef __POWER_H__
+#define __POWER_H__
 
 //
 // Public function prototypes.
 //
 
-void InitializeSwitching();
-void DebounceSwitches();
-void CalculateSwitchStates();
-uint8_t SwitchWasClosed(uint8_t pins);
-uint8_t SwitchWasOpened(uint8_t pins);
-
-void ModifySpeedAdjust(int8_t change_value);
+void InitializePower();
+void SleepUntilNextTick();
 
-#endif // __SWITCHING_H__
+#endif // __POWER_H__
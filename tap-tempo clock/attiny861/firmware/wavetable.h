@@ -0,0 +1,25 @@
+//
+// Generated by tools/wavetable.c; do not edit. Regenerate with
+// "make tables", see the Makefile.
+//
+
+#ifndef __WAVETABLE_H__
+#define __WAVETABLE_H__
+
+#define WAVETABLE_INDEX_BITS            8
+#define WAVETABLE_DEPTH_BITS            10
+#define WAVETABLE_MAX                   1023
+
+#define WAVETABLE_SINE_SIZE             65
+#define WAVETABLE_SINE_QUARTER          1
+
+static const uint16_t k_sine_table[WAVETABLE_SINE_SIZE] PROGMEM =
+{
+        0,     0,     1,     1,     2,     4,     6,     8,    10,    12,    15,    19,    22,    26,    30,    34,
+       39,    44,    49,    55,    60,    66,    73,    79,    86,    93,   101,   108,   116,   124,   133,   141,
+      150,   159,   168,   177,   187,   197,   207,   217,   227,   238,   249,   259,   270,   282,   293,   304,
+      316,   327,   339,   351,   363,   375,   387,   399,   412,   424,   436,   449,   461,   474,   486,   499,
+      512
+};
+
+#endif // __WAVETABLE_H__
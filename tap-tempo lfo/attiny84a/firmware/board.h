@@ -0,0 +1,84 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+//
+// Board glue for the shared tap-tempo core (see common/). Selects the core
+// features this board uses, and hooks its pins into the tempo counting.
+//
+
+#include <avr/io.h>
+
+#include "main.h"
+
+//
+// Core features.
+//
+
+#define ENABLE_WAVEFORM_OUTPUT          1
+#define ENABLE_SINE_INTERPOLATION       1
+#define ENABLE_SMOOTH_RANDOM            1
+#define ENABLE_SPEED_ADJUST             1
+#define ENABLE_TRIPLET_MULTIPLIER       1
+#define ENABLE_QUEUED_SETTINGS          1
+#define ENABLE_SKEW                     1
+
+//
+// Core hooks. The tempo indicator follows the actual (multiplied) waveform,
+// unless telemetry is on; the telemetry output takes over its pin. There's
+// no tempo indicator with the second LFO output on; see main.h.
+//
+
+#define SWITCH_PIN                      PINA
+#define LFO_OUTPUT_COMPARE              OCR0A
+#define SECOND_OUTPUT_COMPARE           OCR0B
+#define PWM_TIMER_COUNT                 TCNT0
+#define PWM_TIMER_OVERFLOW_PENDING()    (TIFR0 & (1 << TOV0))
+
+#define TEMPO_COUNT_STARTED()           PORTA &= ~(1 << SYNC_OUT)   /* Pull low. */
+#define TEMPO_COUNT_STOPPED()           PORTA |= (1 << SYNC_OUT)    /* Pull high. */
+
+#if ENABLE_TELEMETRY && ENABLE_SECOND_OUTPUT
+#error "The second LFO output moves the sync output onto the telemetry pin (PA6); turn one of them off"
+#endif
+
+#if ENABLE_TELEMETRY
+#define TELEMETRY_PORT                  PORTA
+#define TELEMETRY_DDR                   DDRA
+#define TELEMETRY_OUT                   TEMPO_OUT
+#elif !ENABLE_SECOND_OUTPUT
+#define WAVEFORM_CYCLE_COMPLETED()      PORTA ^= (1 << TEMPO_OUT)
+#endif
+
+//
+// Shared state, defined in main.c.
+//
+
+extern volatile uint8_state_flags g_state;
+extern volatile uint16_t g_tempo_ms_count;
+
+#endif // __BOARD_H__
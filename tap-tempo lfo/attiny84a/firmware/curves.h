@@ -0,0 +1,59 @@
+//
+// Generated by tools/wavetable.c; do not edit. Regenerate with
+// "make tables", see the Makefile.
+//
+
+#ifndef __CURVES_H__
+#define __CURVES_H__
+
+#define CURVE_INDEX_BITS                8
+#define CURVE_DEPTH_BITS                8
+#define CURVE_MAX                       255
+
+#define CURVE_EXP_SIZE                  256
+#define CURVE_EXP_QUARTER               0
+
+static const uint8_t k_exp_curve[CURVE_EXP_SIZE] PROGMEM =
+{
+      0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   3,   3,
+      3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   4,   4,   5,   5,
+      5,   5,   5,   5,   5,   6,   6,   6,   6,   6,   6,   7,   7,   7,   7,   7,
+      7,   8,   8,   8,   8,   8,   9,   9,   9,   9,   9,  10,  10,  10,  10,  11,
+     11,  11,  11,  12,  12,  12,  12,  13,  13,  13,  14,  14,  14,  14,  15,  15,
+     15,  16,  16,  16,  17,  17,  17,  18,  18,  18,  19,  19,  20,  20,  20,  21,
+     21,  22,  22,  22,  23,  23,  24,  24,  25,  25,  26,  26,  27,  27,  28,  28,
+     29,  29,  30,  30,  31,  31,  32,  33,  33,  34,  34,  35,  36,  36,  37,  38,
+     38,  39,  40,  40,  41,  42,  43,  43,  44,  45,  46,  47,  47,  48,  49,  50,
+     51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,
+     67,  69,  70,  71,  72,  73,  75,  76,  77,  79,  80,  81,  83,  84,  86,  87,
+     89,  90,  92,  93,  95,  97,  98, 100, 102, 103, 105, 107, 109, 111, 112, 114,
+    116, 118, 120, 122, 124, 127, 129, 131, 133, 135, 138, 140, 142, 145, 147, 150,
+    152, 155, 157, 160, 163, 165, 168, 171, 174, 177, 180, 183, 186, 189, 192, 196,
+    199, 202, 206, 209, 212, 216, 220, 223, 227, 231, 235, 239, 243, 247, 251, 255
+};
+
+#define CURVE_LOG_SIZE                  256
+#define CURVE_LOG_QUARTER               0
+
+static const uint8_t k_log_curve[CURVE_LOG_SIZE] PROGMEM =
+{
+      0,  14,  25,  34,  42,  49,  56,  62,  67,  72,  76,  81,  84,  88,  92,  95,
+     98, 101, 104, 107, 109, 112, 114, 116, 119, 121, 123, 125, 127, 129, 131, 132,
+    134, 136, 137, 139, 141, 142, 144, 145, 146, 148, 149, 150, 152, 153, 154, 155,
+    157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172,
+    173, 174, 175, 176, 177, 177, 178, 179, 180, 181, 181, 182, 183, 184, 185, 185,
+    186, 187, 187, 188, 189, 190, 190, 191, 192, 192, 193, 194, 194, 195, 195, 196,
+    197, 197, 198, 198, 199, 200, 200, 201, 201, 202, 203, 203, 204, 204, 205, 205,
+    206, 206, 207, 207, 208, 208, 209, 209, 210, 210, 211, 211, 212, 212, 213, 213,
+    214, 214, 215, 215, 216, 216, 216, 217, 217, 218, 218, 219, 219, 219, 220, 220,
+    221, 221, 222, 222, 222, 223, 223, 224, 224, 224, 225, 225, 225, 226, 226, 227,
+    227, 227, 228, 228, 228, 229, 229, 230, 230, 230, 231, 231, 231, 232, 232, 232,
+    233, 233, 233, 234, 234, 234, 235, 235, 235, 236, 236, 236, 237, 237, 237, 238,
+    238, 238, 239, 239, 239, 239, 240, 240, 240, 241, 241, 241, 242, 242, 242, 242,
+    243, 243, 243, 244, 244, 244, 244, 245, 245, 245, 246, 246, 246, 246, 247, 247,
+    247, 247, 248, 248, 248, 249, 249, 249, 249, 250, 250, 250, 250, 251, 251, 251,
+    251, 252, 252, 252, 252, 253, 253, 253, 253, 254, 254, 254, 254, 255, 255, 255
+};
+
+#endif // __CURVES_H__
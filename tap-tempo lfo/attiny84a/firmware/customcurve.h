@@ -0,0 +1,31 @@
+//
+// Generated by tools/customwave.c from curve.csv; do not edit. Regenerate
+// with "make custom-curve", see the Makefile.
+//
+
+#ifndef __CUSTOMCURVE_H__
+#define __CUSTOMCURVE_H__
+
+#define CUSTOMCURVE_POINTS              256
+
+static const uint8_t k_custom_curve[CUSTOMCURVE_POINTS] PROGMEM =
+{
+      0,   0,   0,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   3,   3,
+      3,   4,   4,   5,   5,   6,   6,   7,   7,   8,   8,   9,   9,  10,  10,  11,
+     11,  12,  13,  14,  14,  15,  16,  17,  18,  18,  19,  20,  21,  22,  23,  23,
+     24,  25,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,
+     40,  41,  43,  44,  45,  46,  47,  49,  50,  51,  52,  53,  55,  56,  57,  58,
+     59,  61,  62,  64,  65,  66,  68,  69,  70,  72,  73,  75,  76,  77,  79,  80,
+     82,  83,  84,  86,  87,  89,  90,  92,  93,  95,  96,  97,  99, 100, 102, 103,
+    105, 106, 108, 109, 111, 112, 114, 115, 117, 118, 120, 121, 123, 124, 126, 127,
+    129, 130, 132, 133, 134, 136, 137, 139, 140, 142, 143, 145, 146, 147, 149, 150,
+    152, 153, 155, 156, 158, 159, 160, 162, 163, 165, 166, 168, 169, 171, 172, 173,
+    175, 176, 178, 179, 180, 182, 183, 185, 186, 187, 189, 190, 191, 193, 194, 196,
+    197, 198, 199, 200, 202, 203, 204, 205, 206, 208, 209, 210, 211, 212, 214, 215,
+    216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231,
+    232, 232, 233, 234, 235, 236, 237, 237, 238, 239, 240, 241, 241, 242, 243, 244,
+    244, 245, 245, 246, 246, 247, 247, 248, 248, 249, 249, 250, 250, 251, 251, 252,
+    252, 252, 253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 255, 255, 255
+};
+
+#endif // __CUSTOMCURVE_H__
@@ -0,0 +1,19 @@
+//
+// Generated by tools/customwave.c from custom.csv; do not edit. Regenerate
+// with "make custom", see the Makefile.
+//
+
+#ifndef __CUSTOMWAVE_H__
+#define __CUSTOMWAVE_H__
+
+#define CUSTOMWAVE_POINTS               64
+
+static const uint8_t k_custom_waveform[CUSTOMWAVE_POINTS] PROGMEM =
+{
+      0,   0,   1,   1,   1,   2,   2,   2,   3,   3,   4,   4,   5,   5,   6,   7,
+      7,   8,   9,  10,  11,  12,  13,  14,  15,  16,  18,  19,  21,  23,  24,  26,
+     28,  31,  33,  35,  38,  41,  44,  47,  50,  54,  58,  62,  67,  71,  76,  82,
+     88,  94, 100, 107, 115, 123, 131, 140, 150, 160, 171, 183, 196, 209, 223, 239
+};
+
+#endif // __CUSTOMWAVE_H__
@@ -39,10 +39,18 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#include <util/atomic.h>
 
 #include "switching.h"
+#include "selection.h"
+#include "encoder.h"
 #include "signaling.h"
+#include "critical.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "power.h"
+#include "supervision.h"
+#include "persistence.h"
+#include "presets.h"
 #include "main.h"
 
 //
@@ -74,15 +82,19 @@
 //
 
 volatile uint8_state_flags g_state;
+volatile uint8_t g_has_pending_tick;
+volatile uint8_t g_is_counting_standby_time;
 
 volatile uint16_t g_tempo_ms_count;
 volatile uint16_t g_mode_reset_ms_count;
+volatile uint16_t g_standby_ms_count;
 
 extern volatile uint8_t g_base_table_index;
 extern volatile uint32_t g_base_duty_cycle;
 extern volatile uint32_t g_base_phase_accumulator;
+extern volatile uint8_t g_supervision_sample_count;
 
-extern volatile uint16_t g_speed_adjustment_ms_count;
+extern volatile uint16_t g_speed_adjust_ms_count;
 
 /*====== Public functions ===================================================== 
 =============================================================================*/
@@ -98,7 +110,11 @@ int main()
     // are to be input pins).
     //
     
+#if ENABLE_SECOND_OUTPUT
+    DDRA = (1 << WAVE_MODE_OUT) | (1 << MULTI_MODE_OUT) | (1 << SYNC_OUT) | (1 << LFO_2_OUT);
+#else
     DDRA = (1 << WAVE_MODE_OUT) | (1 << MULTI_MODE_OUT) | (1 << SYNC_OUT) | (1 << TEMPO_OUT);
+#endif
     DDRB = (1 << SPEED_MODE_OUT) | (1 << LFO_OUT);
     
     //
@@ -108,11 +124,20 @@ int main()
     PORTA = 0xff;
     PORTB = 0xff;
     
+#if ENABLE_TRACE
     //
-    // Initialize switching.
+    // Pick up the event trace from before the reset, if it survived.
+    //
+    
+    InitializeTrace(GetResetCause());
+#endif
+    
+    //
+    // Initialize switching and the selection modes.
     //
     
     InitializeSwitching();
+    InitializeSelection();
     
     //
     // Set up the random number generator for the random waveform.
@@ -121,11 +146,41 @@ int main()
     SeedRandomNumberGenerator(0);
     UpdateRandomNumber();
     
+#if ENABLE_CUSTOM_WAVEFORM
     //
-    // Initialize signaling, including setting the default base tempo.
+    // Pick up the custom waveform, from EEPROM if one has been uploaded,
+    // otherwise the one built in.
+    //
+    
+    LoadCustomWaveform();
+    
+#endif
+    //
+    // Initialize signaling, including setting the default base tempo. The
+    // settings last committed to EEPROM take precedence over the defaults,
+    // and after anything but a power-on reset (e.g. the watchdog having
+    // kicked in) the settings from right before the reset take precedence
+    // over both, if still intact.
     //
     
     SetBaseTempo(DEFAULT_TEMPO);
+    InitializePersistence();
+    RecoverSettings();
+    
+#if ENABLE_WAVEFORM_MORPH
+    //
+    // The morph table has to be valid before the PWM interrupt starts reading
+    // from it.
+    //
+    
+    InitializeMorphTable();
+#elif ENABLE_OUTPUT_SCALING
+    //
+    // Likewise the output table.
+    //
+    
+    InitializeOutputTable();
+#endif
     
     //
     // Disable USI and ADC to conserve power.
@@ -133,6 +188,20 @@ int main()
     
     PRR = (1 << PRUSI) | (1 << PRADC);
     
+#if ENABLE_TELEMETRY
+    //
+    // Set up the telemetry output pin.
+    //
+    
+    InitializeTelemetry();
+#endif
+    
+    //
+    // Set up idle sleep for the main loop.
+    //
+    
+    InitializePower();
+    
     //
     // Set up Timer0 in fast PWM mode with no prescaler and a non-inverted
     // compare.
@@ -140,6 +209,9 @@ int main()
     //
     
     TCCR0A = (1 << COM0A1);                 // Clear OC0A on compare match. Set OC0A at BOTTOM.
+#if ENABLE_SECOND_OUTPUT
+    TCCR0A |= (1 << COM0B1);                // Same for OC0B, the second LFO output.
+#endif
     TCCR0A |= (1 << WGM01) | (1 << WGM00);  // Fast-PWM (TOP == 0xff).
     TCCR0B = (1 << CS00);                   // No prescaler.
     TIMSK0 = (1 << TOIE0);                  // Timer0 overflow interrupt.
@@ -175,6 +247,13 @@ int main()
     GIMSK = (1 << PCIE0) | (1 << PCIE1);    // Enable pin change interrupts on
                                             // both PCINT7:0 and PCINT11:8.
     
+    //
+    // Start the watchdog. From here on both the 1ms tick and the main loop
+    // have to keep checking in; see supervision.c.
+    //
+    
+    InitializeSupervision();
+    
     //
     // Enable global interrupts. No interrupts will happen without this,
     // regardless of individual flags set elsewhere.
@@ -189,7 +268,57 @@ int main()
     while (1)
     {
         //
-        // Continuously poll the tap input switch.
+        // Sleep until the next 1ms tick; see SleepUntilNextTick().
+        //
+        
+        SleepUntilNextTick();
+        
+#if ENABLE_TELEMETRY
+        //
+        // Queue up the next telemetry frame once the last one is out.
+        //
+        
+        UpdateTelemetry();
+#endif
+        
+        //
+        // Check in with the watchdog.
+        //
+        
+        SuperviseMainLoop();
+        
+        //
+        // Commit the settings to EEPROM once they've stopped changing.
+        //
+        
+        UpdatePersistence();
+        
+        //
+        // Apply any encoder steps, or mode reset, the interrupts have queued
+        // up since the last tick; see QueueSelectionChange().
+        //
+        
+        UpdateSelection();
+        
+#if ENABLE_WAVEFORM_MORPH
+        //
+        // Carry on with the morph table, if it's being rebuilt; a few entries
+        // per tick.
+        //
+        
+        UpdateMorphTable();
+#elif ENABLE_OUTPUT_SCALING
+        //
+        // Likewise the output table, after a depth or level change.
+        //
+        
+        UpdateOutputTable();
+#endif
+        
+        //
+        // Poll the tap input switch, once per tick. The switch samples are
+        // only updated by the tick interrupt, so there's nothing new to find
+        // in between and no tap latency added by sleeping.
         //
         // Note: This routine has been moved to the main loop so as not to
         //       delay the interrupt processing unnecessarily. There is enough
@@ -215,41 +344,105 @@ int main()
             // switch.
             //  
             
-            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            TRACE(TraceEventTap, 0);
+            
+            g_standby_ms_count = 0;
+            g_is_counting_standby_time = 1;
+            
+            //
+            // With the mode switch held down the tap switch handles presets
+            // instead; see below. Stop the mode reset count so that the mode
+            // switch release is ignored as well.
+            //
+            
+            if (SwitchIsClosed(1 << MODE_IN))
+            {
+                g_state.is_handling_preset = 1;
+                g_state.is_counting_mode_reset_time = 0;
+                g_mode_reset_ms_count = 0;
+            }
+            else
             {
+                PROFILED_ATOMIC_BLOCK(CriticalSectionTap)
+                {
+                    //
+                    // Always reset the output signal on a manual tap.
+                    //
+                    
+                    if (g_state.is_counting_tempo == 0)
+                    {
+                        ResetSignals();
+                        StartTempoCount();
+                    }
+                    else
+                    {
+                        ResetSignals();
+                        StopTempoCount();
+                        
+                        g_state.has_received_tap_input = 1;
+                    }
+                }
+                
                 //
-                // Always reset the output signal on a manual tap.
+                // Just once, use the newly entered tap tempo value to seed
+                // the random number generator, so it will be different
+                // each time.
                 //
                 
-                if (g_state.is_counting_tempo == 0)
+                if (g_state.has_random_seed == 0)
                 {
-                    ResetSignals();
-                    StartTempoCount();
-                }
-                else
-                {
-                    ResetSignals();
-                    StopTempoCount();
-                    
-                    g_state.has_received_tap_input = 1;
+                    if (g_state.has_received_tap_input == 0)
+                    {
+                        g_state.has_random_seed = 1;
+                        
+                        SeedRandomNumberGenerator(g_tempo_ms_count);
+                        UpdateRandomNumber();
+                    }
                 }
             }
-            
+        }
+        
+        if (SwitchWasOpened(1 << TAP_IN))
+        {
             //
-            // Just once, use the newly entered tap tempo value to seed
-            // the random number generator, so it will be different
-            // each time.
+            // Holding the tap switch for a few seconds before releasing it
+            // puts the unit in standby. Any tap, mode switch press or sync
+            // pulse wakes it up again with the same settings.
             //
             
-            if (g_state.has_random_seed == 0)
+            g_is_counting_standby_time = 0;
+            
+            if (g_state.is_handling_preset == 1)
             {
-                if (g_state.has_received_tap_input == 0)
+                //
+                // Tapping while holding the mode switch recalls the next
+                // preset, and holding the tap switch for a few seconds stores
+                // the current settings to the current preset instead.
+                //
+                
+                g_state.is_handling_preset = 0;
+                
+                if (g_standby_ms_count >= PRESET_STORE_MIN_TIME)
                 {
-                    g_state.has_random_seed = 1;
-                    
-                    SeedRandomNumberGenerator(g_tempo_ms_count);
-                    UpdateRandomNumber();
+                    StoreCurrentPreset();
                 }
+                else
+                {
+                    RecallNextPreset();
+                }
+            }
+            else if (g_standby_ms_count >= STANDBY_MIN_TIME)
+            {
+                //
+                // Clear the count first. The press that wakes us up is never
+                // seen as a tap (see ResumeSwitching()), but its release is,
+                // and must not find the old count and go straight back into
+                // standby.
+                //
+                
+                g_standby_ms_count = 0;
+                
+                EnterStandby();
             }
         }
         
@@ -270,17 +463,20 @@ int main()
             // specified number of seconds, interpret the switch release as
             // reset of the current mode rather than a regular mode change.
             //
+            // Note: Only if the switch was seen closing in the first place;
+            //       the press that wakes the unit from standby is ignored.
+            //
             
             if (g_state.is_resetting_mode == 1)
             {
                 g_state.is_resetting_mode = 0;
             }
-            else
+            else if (g_state.is_counting_mode_reset_time == 1)
             {
                 g_state.is_counting_mode_reset_time = 0;
                 g_mode_reset_ms_count = 0;
                 
-                ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+                PROFILED_ATOMIC_BLOCK(CriticalSectionSelection)
                 {
                     SetNextSelectionMode();
                 }
@@ -295,10 +491,14 @@ int main()
 // Frequency: 31.25kHz
 //
 
-ISR(TIM0_OVF_vect)
+ISR(TIM0_OVF_vect, ISR_FLATTEN)
 {
     uint8_t previous_base_table_index = g_base_table_index;
     
+    PWM_INTERRUPT_ENTERED();
+    
+    g_supervision_sample_count++;
+    
     //
     // Increase the phase accumulator by a given amount based on the required
     // output signal frequency. Then use the high 8 bits (0-255) of the phase
@@ -342,6 +542,12 @@ ISR(TIM0_OVF_vect)
             PORTA ^= (1 << SYNC_OUT);   // Pull high->low or low->high.
             //AlignWaveform();
         }
+        
+        //
+        // Pick up a recalled preset, if any, right on the cycle boundary.
+        //
+        
+        ApplyQueuedSettings();
     }
     
     //
@@ -349,6 +555,8 @@ ISR(TIM0_OVF_vect)
     //
     
     PlotWaveform();
+    
+    PWM_INTERRUPT_LEAVING();
 }
 
 //
@@ -405,7 +613,7 @@ ISR(TIM1_COMPA_vect)
             g_state.is_counting_mode_reset_time = 0;
             g_mode_reset_ms_count = 0;
             
-            ResetCurrentSelectionMode();
+            QueueSelectionReset();
         }
     }
     
@@ -413,54 +621,60 @@ ISR(TIM1_COMPA_vect)
     // Keep the speed adjustment time counter topped up, if possible.
     //
     
-    if (g_speed_adjustment_ms_count < 0xffff)
+    if (g_speed_adjust_ms_count < 0xffff)
     {
-        g_speed_adjustment_ms_count++;
+        g_speed_adjust_ms_count++;
     }
-}
-
-//
-// Pin change interrupt handler. Handles the rotary encoder.
-//
-
-ISR(PCINT0_vect)
-{
-    static const int8_t encoder_table[16] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
-    static uint8_t encoder_samples = 3;
-    static int8_t encoder_value = 0;
     
     //
-    // Keep sampling the four latest rotary states, as pairs of bits, in a
-    // shift register. Make room for the next sample (and discard the oldest
-    // one).
+    // Count standby hold time, if applicable.
     //
     
-    encoder_samples <<= 2;
+    if ((g_is_counting_standby_time == 1) && (g_standby_ms_count < 0xffff))
+    {
+        g_standby_ms_count++;
+    }
     
     //
-    // Since the current rotary samples need to be added to the shift
-    // register at the start, and they do not necessarily align pin-wise, they
-    // must be adjusted accordingly.
+    // Check in with the watchdog, as long as the PWM interrupt is keeping up.
     //
     
-    encoder_samples |= ((PINA & (1 << ROTARY_A_IN)) >> ROTARY_A_IN) | ((PINA & (1 << ROTARY_B_IN)) >> (ROTARY_B_IN - 1));
+    SuperviseTick();
     
+#if ENABLE_TRACE
     //
-    // Update the encoder value and check the result.
+    // Keep the trace time stamps going.
     //
     
-    encoder_value += encoder_table[(encoder_samples & 0x0f)];
-    if (encoder_value > 3)
-    {
-        ModifyCurrentSelectionMode(1);
-        
-        encoder_value = 0;
-    }
-    else if (encoder_value < -3)
+    TRACE_TICK();
+#endif
+    
+#if ENABLE_TELEMETRY
+    //
+    // Next telemetry bit out.
+    //
+    
+    TransmitTelemetry();
+#endif
+    
+    //
+    // Let the main loop know there's a new tick to deal with.
+    //
+    
+    g_has_pending_tick = 1;
+}
+
+//
+// Pin change interrupt handler. Handles the rotary encoder.
+//
+
+ISR(PCINT0_vect)
+{
+    int8_t change_value = DecodeEncoder(PINA);
+    
+    if (change_value != 0)
     {
-        ModifyCurrentSelectionMode(-1);
-        
-        encoder_value = 0;
+        QueueSelectionChange(change_value);
     }
 }
 
@@ -481,6 +695,8 @@ ISR(PCINT1_vect)
     {
         previous_sync_input = sync_input;
 
+        TRACE(TraceEventSync, (sync_input != 0));
+        
         //
         // Detect whether this is a falling or rising edge, and start or stop
         // the tempo counting accordingly.
@@ -33,7 +33,9 @@
 #define CLOCK_FREQUENCY     			8000000UL
 
 //
-// Pin configuration defines.
+// Pin configuration defines. With the second LFO output (a build option, see
+// the Makefile) OC0B takes over the sync output's pin, and the sync output
+// takes over the tempo indicator's.
 //
 
 #define TAP_IN                  		PA0     /* Tap switch input */
@@ -42,8 +44,13 @@
 #define MODE_IN                 		PA3     /* Mode switch input */
 #define ROTARY_A_IN             		PA4     /* Rotary interrupt input A */
 #define ROTARY_B_IN             		PA5     /* Rotary interrupt input B */
+#if ENABLE_SECOND_OUTPUT
+#define SYNC_OUT                		PA6     /* Base tempo indicator / sync output */
+#define LFO_2_OUT               		PA7     /* OC0B PWM timer output, second LFO output */
+#else
 #define TEMPO_OUT               		PA6     /* Actual multiplier tempo indicator */
 #define SYNC_OUT                		PA7     /* Base tempo indicator / sync output */
+#endif
 #define SPEED_MODE_OUT          		PB0     /* Speed adjust mode indicator */
 #define SYNC_IN                 		PB1     /* External sync signal interrupt input */
 #define LFO_OUT                 		PB2     /* OC0A PWM timer output */
@@ -53,6 +60,14 @@
 // Various boolean flags wrapped up in a single byte to save space (not sure if
 // actually ends up taking less space when compiled).
 //
+// Note: The main loop updates these with a read-modify-write of the whole
+//       byte, not always inside an atomic block. The tick flag is set from the
+//       timer interrupt on every tick, and the standby flag is set and
+//       cleared by the main loop while the timer interrupt goes by it, so
+//       they're kept apart (g_has_pending_tick and
+//       g_is_counting_standby_time in main.c) rather than risk either one
+//       being lost.
+//
 
 typedef struct
 {
@@ -61,7 +76,7 @@ typedef struct
     uint8_t is_resetting_mode:1;
     uint8_t has_random_seed:1;
     uint8_t has_received_tap_input:1;
-    uint8_t reserved:3;
+    uint8_t is_handling_preset:1;
 } uint8_state_flags;
 
 #endif // __MAIN_H__
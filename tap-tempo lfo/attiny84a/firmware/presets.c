@@ -0,0 +1,180 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Note: Presets are kept in EEPROM, one slot per preset, each with its own
+//       checksum so that a slot never stored to (or only partially stored
+//       to) is skipped when recalling. The index of the current preset is
+//       only kept in SRAM.
+//
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+
+#include "main.h"
+#include "signaling.h"
+#include "critical.h"
+#include "persistence.h"
+#include "supervision.h"
+#include "presets.h"
+
+//
+// Defines and structs.
+//
+
+#define PRESET_CHECKSUM_SEED            0xc3
+
+//
+// Index value for when no preset has been recalled or stored yet. The next
+// one after it is the first slot.
+//
+
+#define PRESET_NONE                     0xff
+
+typedef struct
+{
+    lfo_settings settings;
+    uint8_t checksum;
+} preset_record;
+
+//
+// Local function prototypes.
+//
+
+uint8_t CalculatePresetChecksum(const preset_record *record);
+
+//
+// Global variables.
+//
+
+preset_record g_eeprom_presets[PRESET_COUNT] EEMEM;
+
+uint8_t g_preset_index = PRESET_NONE;
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void RecallNextPreset()
+{
+    uint8_t count;
+    uint8_t index = g_preset_index;
+    preset_record record;
+    
+    //
+    // Move on to the next slot that has a preset stored in it, wrapping
+    // around at the end. Empty slots are skipped, and if there are no
+    // presets stored at all nothing happens.
+    //
+    // The recalled settings are only queued here. They take effect at the
+    // start of the next base tempo cycle; see QueueSettings().
+    //
+    // The settings ring may be in the middle of an interrupt driven write,
+    // which would move the EEPROM address out from under the reads; let it
+    // finish first. There's nothing to commit, so no need for a flush.
+    //
+    
+    WaitForPersistence();
+    
+    for (count = 0; count < PRESET_COUNT; count++)
+    {
+        index++;
+        
+        if (index >= PRESET_COUNT)
+        {
+            index = 0;
+        }
+        
+        eeprom_read_block(&record, &g_eeprom_presets[index], sizeof(preset_record));
+        
+        if (record.checksum != CalculatePresetChecksum(&record))
+        {
+            continue;
+        }
+        
+        if (QueueSettings(&record.settings))
+        {
+            g_preset_index = index;
+            
+            return;
+        }
+    }
+}
+
+void StoreCurrentPreset()
+{
+    preset_record record;
+    
+    //
+    // Store the current settings to the slot last recalled, or the first one
+    // if none has been recalled yet.
+    //
+    
+    if (g_preset_index >= PRESET_COUNT)
+    {
+        g_preset_index = 0;
+    }
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSettings)
+    {
+        GetSettings(&record.settings);
+    }
+    
+    record.checksum = CalculatePresetChecksum(&record);
+    
+    //
+    // The settings ring may be in the middle of an interrupt driven write,
+    // and can't share the EEPROM with us until it's done. Flushing it also
+    // keeps it from starting another write for as long as we're busy, since
+    // that only ever happens from the main loop.
+    //
+    // Note: This blocks for up to a few tens of milliseconds, which is fine
+    //       for something that only happens on a long switch press. Only the
+    //       bytes that actually differ are written. The flush and the preset
+    //       write together can come close to the watchdog timeout, so check
+    //       in between the two.
+    //
+    
+    FlushPersistence();
+    
+    SuperviseMainLoop();
+    
+    eeprom_update_block(&record, &g_eeprom_presets[g_preset_index], sizeof(preset_record));
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+uint8_t CalculatePresetChecksum(const preset_record *record)
+{
+    uint8_t count;
+    uint8_t checksum = PRESET_CHECKSUM_SEED;
+    const uint8_t *data = (const uint8_t *)&record->settings;
+    
+    for (count = 0; count < sizeof(lfo_settings); count++)
+    {
+        checksum = ((checksum << 1) | (checksum >> 7)) + data[count];
+    }
+    
+    return checksum;
+}
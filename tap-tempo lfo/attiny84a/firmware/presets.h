@@ -1,5 +1,5 @@
 //
-// Tap-tempo clock for 8-bit AVR.
+// Tap-tempo LFO for 8-bit AVR.
 // 
 // Copyright (C) 2013-2016 Harald Sabro
 // 
@@ -22,36 +22,32 @@
 // Email: harald (AT) website 
 //
 
-#ifndef __SIGNALING_H__
-#define __SIGNALING_H__
+#ifndef __PRESETS_H__
+#define __PRESETS_H__
 
 //
 // Defines and structs.
 //
 
 //
-// In milliseconds = 0.1Hz, 10 seconds
+// Number of preset slots in EEPROM.
 //
 
-#define LFO_MIN_TEMPO           		10000
+#define PRESET_COUNT                    4
 
 //
-// In milliseconds = 20Hz, 5/100ths of a second
+// Millisecond count before a tap switch press (while the mode switch is held)
+// is interpreted as storing the current preset rather than recalling the
+// next one.
 //
 
-#define LFO_MAX_TEMPO           		50
+#define PRESET_STORE_MIN_TIME           2000
 
 //
 // Public function prototypes.
 //
 
-void SetBaseTempo(uint16_t milliseconds);
-void StartTempoCount();
-void StopTempoCount();
-void TempoCountTimeout();
-void ResetBaseTempo();
+void RecallNextPreset();
+void StoreCurrentPreset();
 
-void AdjustSpeed(int16_t change_value);
-void ResetSpeedAdjustSetting();
-
-#endif // __SIGNALING_H__
+#endif // __PRESETS_H__
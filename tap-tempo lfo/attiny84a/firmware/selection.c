@@ -0,0 +1,629 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+
+#include <avr/io.h>
+
+#include "main.h"
+#include "signaling.h"
+#include "critical.h"
+#include "trace.h"
+#include "selection.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Skew change per encoder step; 29 steps from the center to either end, see
+// SetSkew().
+//
+
+#define SKEW_ENCODER_STEP           4
+
+#if ENABLE_WAVEFORM_MORPH
+//
+// Morph position change per encoder step; 16 steps between each of the
+// morph waveforms, see SetMorphPosition().
+//
+
+#define MORPH_ENCODER_STEP          4
+#endif
+
+#if ENABLE_SECOND_OUTPUT
+//
+// Second output phase offset change per encoder step; 22.5 degrees, so 90
+// and 180 degrees are 4 and 8 steps from zero.
+//
+
+#define OFFSET_ENCODER_STEP         16
+#endif
+
+#if ENABLE_OUTPUT_SCALING
+//
+// Output depth and level change per encoder step; 32 steps from one end to
+// the other, see SetOutputDepth().
+//
+
+#define SCALING_ENCODER_STEP        8
+#endif
+
+typedef enum
+{
+    SelectionModeSpeed = 0,
+    SelectionModeWaveform,
+    SelectionModeSkew,
+#if ENABLE_TRANSFER_CURVE
+    SelectionModeCurve,
+#endif
+    SelectionModeMultiplier,
+#if ENABLE_SECOND_OUTPUT
+    SelectionModeOffset,
+#endif
+#if ENABLE_OUTPUT_SCALING
+    SelectionModeDepth,
+    SelectionModeLevel
+#endif
+} SelectionMode;
+
+//
+// Local function prototypes.
+//
+
+void ModifyCurrentSelectionMode(int8_t change_value);
+void ResetCurrentSelectionMode();
+
+#if ENABLE_WAVEFORM_MORPH
+void StepMorphPosition(int8_t change_value);
+#else
+void StepWaveform(int8_t change_value);
+#endif
+void StepSkew(int8_t change_value);
+void StepMultiplier(int8_t change_value);
+
+#if ENABLE_TRANSFER_CURVE
+void StepTransferCurve(int8_t change_value);
+#endif
+
+#if ENABLE_SECOND_OUTPUT
+void StepSecondOutputOffset(int8_t change_value);
+#endif
+
+#if ENABLE_OUTPUT_SCALING
+uint8_t StepScaling(uint8_t value, int8_t change_value);
+#endif
+
+//
+// Global variables.
+//
+
+volatile SelectionMode g_selection_mode = SelectionModeSpeed;
+
+//
+// Encoder steps and mode reset requests, handed over from the interrupts to
+// UpdateSelection(); see QueueSelectionChange().
+//
+
+volatile int8_t g_pending_selection_change;
+volatile uint8_t g_has_pending_selection_reset;
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializeSelection()
+{
+    //
+    // Start out in speed adjust mode, with only its indicator turned on.
+    //
+    // Note: Which mode comes before speed adjust depends on the Makefile
+    //       options (see SelectionMode), so set it directly rather than
+    //       toggling on from another mode.
+    //
+    
+    g_selection_mode = SelectionModeSpeed;
+    
+    PORTA |= (1 << WAVE_MODE_OUT) | (1 << MULTI_MODE_OUT);
+    PORTB &= ~(1 << SPEED_MODE_OUT);
+}
+
+void SetNextSelectionMode()
+{
+    //
+    // Pull all mode indicator pins high to turn them off.
+    //
+    
+    PORTA |= (1 << WAVE_MODE_OUT) | (1 << MULTI_MODE_OUT);
+    PORTB |= (1 << SPEED_MODE_OUT);
+    
+    switch (g_selection_mode)
+    {
+        case SelectionModeSpeed:
+        
+            //
+            // Switch to waveform mode and turn on the associated indicator.
+            //
+            
+            g_selection_mode = SelectionModeWaveform;
+            PORTA &= ~(1 << WAVE_MODE_OUT);
+            break;
+        
+        case SelectionModeWaveform:
+        
+            //
+            // Switch to skew mode. There's no indicator of its own, so it's
+            // shown by turning on both the waveform and the multiplier
+            // indicators.
+            //
+            
+            g_selection_mode = SelectionModeSkew;
+            PORTA &= ~((1 << WAVE_MODE_OUT) | (1 << MULTI_MODE_OUT));
+            break;
+        
+        case SelectionModeSkew:
+        
+#if ENABLE_TRANSFER_CURVE
+            //
+            // Switch to transfer curve mode, shown by turning on both the
+            // waveform and the speed adjust indicators.
+            //
+            
+            g_selection_mode = SelectionModeCurve;
+            PORTA &= ~(1 << WAVE_MODE_OUT);
+            PORTB &= ~(1 << SPEED_MODE_OUT);
+            break;
+        
+        case SelectionModeCurve:
+        
+#endif
+            //
+            // Switch to multiplier mode and turn on the associated indicator.
+            //
+            
+            g_selection_mode = SelectionModeMultiplier;
+            PORTA &= ~(1 << MULTI_MODE_OUT);
+            break;
+        
+        case SelectionModeMultiplier:
+        
+#if ENABLE_SECOND_OUTPUT
+            //
+            // Switch to second output offset mode, shown by turning on both
+            // the multiplier and the speed adjust indicators.
+            //
+            
+            g_selection_mode = SelectionModeOffset;
+            PORTA &= ~(1 << MULTI_MODE_OUT);
+            PORTB &= ~(1 << SPEED_MODE_OUT);
+            break;
+        
+        case SelectionModeOffset:
+        
+#endif
+#if ENABLE_OUTPUT_SCALING
+            //
+            // Switch to output depth mode, shown by turning on all three
+            // indicators.
+            //
+            
+            g_selection_mode = SelectionModeDepth;
+            PORTA &= ~((1 << WAVE_MODE_OUT) | (1 << MULTI_MODE_OUT));
+            PORTB &= ~(1 << SPEED_MODE_OUT);
+            break;
+        
+        case SelectionModeDepth:
+        
+            //
+            // Switch to output level mode. There are no indicator
+            // combinations left, so it's shown by leaving them all off.
+            //
+            
+            g_selection_mode = SelectionModeLevel;
+            break;
+        
+        case SelectionModeLevel:
+        
+#endif
+            //
+            // Switch to speed adjust mode and turn on the associated
+            // indicator.
+            //
+            
+            g_selection_mode = SelectionModeSpeed;
+            PORTB &= ~(1 << SPEED_MODE_OUT);
+            break;
+        
+        default:
+            break;
+    }
+    
+    TRACE(TraceEventMode, g_selection_mode);
+}
+
+void QueueSelectionChange(int8_t change_value)
+{
+    int16_t pending_change = g_pending_selection_change + change_value;
+    
+    //
+    // Called from the encoder interrupt. Changing the skew or multiplier
+    // takes floating point divisions (see RecalculateSkew()), far too long
+    // to hold up the PWM interrupt with, so the steps are only added up here
+    // and left for the main loop.
+    //
+    
+    if (pending_change > 127)
+    {
+        pending_change = 127;
+    }
+    else if (pending_change < -127)
+    {
+        pending_change = -127;
+    }
+    
+    g_pending_selection_change = pending_change;
+}
+
+void QueueSelectionReset()
+{
+    //
+    // Called from the tick interrupt once the mode switch has been held long
+    // enough; likewise left for the main loop.
+    //
+    
+    g_has_pending_selection_reset = 1;
+}
+
+void UpdateSelection()
+{
+    int8_t change_value;
+    uint8_t has_reset;
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionSelection)
+    {
+        change_value = g_pending_selection_change;
+        has_reset = g_has_pending_selection_reset;
+        
+        g_pending_selection_change = 0;
+        g_has_pending_selection_reset = 0;
+    }
+    
+    if (has_reset)
+    {
+        ResetCurrentSelectionMode();
+    }
+    
+    //
+    // One encoder step at a time, as they came in; the step functions (and
+    // the speed adjust acceleration) all go by single steps.
+    //
+    
+    while (change_value > 0)
+    {
+        ModifyCurrentSelectionMode(1);
+        change_value--;
+    }
+    
+    while (change_value < 0)
+    {
+        ModifyCurrentSelectionMode(-1);
+        change_value++;
+    }
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+void ModifyCurrentSelectionMode(int8_t change_value)
+{
+    switch (g_selection_mode)
+    {
+        case SelectionModeSpeed:
+        
+            //
+            // The speed adjustment recalculates the tempo, which the tap and
+            // sync handling also does from interrupts, so it's done atomically
+            // as it was back when this ran in the encoder interrupt.
+            //
+            
+            PROFILED_ATOMIC_BLOCK(CriticalSectionSelection)
+            {
+                ModifySpeedAdjust(change_value);
+            }
+            break;
+        
+        case SelectionModeWaveform:
+        
+#if ENABLE_WAVEFORM_MORPH
+            StepMorphPosition(change_value);
+#else
+            StepWaveform(change_value);
+#endif
+            break;
+        
+        case SelectionModeSkew:
+        
+            StepSkew(change_value);
+            break;
+        
+#if ENABLE_TRANSFER_CURVE
+        case SelectionModeCurve:
+        
+            StepTransferCurve(change_value);
+            break;
+#endif
+        
+        case SelectionModeMultiplier:
+        
+            StepMultiplier(change_value);
+            break;
+        
+#if ENABLE_SECOND_OUTPUT
+        case SelectionModeOffset:
+        
+            StepSecondOutputOffset(change_value);
+            break;
+#endif
+        
+#if ENABLE_OUTPUT_SCALING
+        case SelectionModeDepth:
+        
+            SetOutputDepth(StepScaling(GetOutputDepth(), change_value));
+            break;
+        
+        case SelectionModeLevel:
+        
+            SetOutputOffset(StepScaling(GetOutputOffset(), change_value));
+            break;
+#endif
+        
+        default:
+            break;
+    }
+}
+
+void ResetCurrentSelectionMode()
+{
+    switch (g_selection_mode)
+    {
+        case SelectionModeSpeed:
+        
+            PROFILED_ATOMIC_BLOCK(CriticalSectionSelection)
+            {
+                ResetSpeedAdjustSetting();
+            }
+            break;
+        
+        case SelectionModeWaveform:
+        
+#if ENABLE_WAVEFORM_MORPH
+            SetMorphPosition(0x00);
+#else
+            SelectWaveform(WaveformSine);
+#endif
+            break;
+        
+        case SelectionModeSkew:
+        
+            SetSkew(0x80);
+            break;
+        
+#if ENABLE_TRANSFER_CURVE
+        case SelectionModeCurve:
+        
+            SelectTransferCurve(TransferCurveLinear);
+            break;
+#endif
+        
+        case SelectionModeMultiplier:
+        
+            SelectMultiplier(MultiplierQuarter);
+            break;
+        
+#if ENABLE_SECOND_OUTPUT
+        case SelectionModeOffset:
+        
+            SetSecondOutputOffset(SECOND_OUTPUT_DEFAULT_OFFSET);
+            break;
+#endif
+        
+#if ENABLE_OUTPUT_SCALING
+        case SelectionModeDepth:
+        
+            SetOutputDepth(OUTPUT_DEFAULT_DEPTH);
+            break;
+        
+        case SelectionModeLevel:
+        
+            SetOutputOffset(OUTPUT_DEFAULT_OFFSET);
+            break;
+#endif
+        
+        default:
+            break;
+    }
+}
+
+#if ENABLE_WAVEFORM_MORPH
+void StepMorphPosition(int8_t change_value)
+{
+    int16_t position = GetMorphPosition() + (change_value * MORPH_ENCODER_STEP);
+    
+    //
+    // Move the morph position along, stopping at either end like the
+    // multiplier does; wrapping around would jump from ramp down straight
+    // back to sine.
+    //
+    
+    if (position < 0x00)
+    {
+        position = 0x00;
+    }
+    else if (position > 0xff)
+    {
+        position = 0xff;
+    }
+    
+    SetMorphPosition(position);
+}
+#else
+void StepWaveform(int8_t change_value)
+{
+    uint8_t waveform = GetWaveform();
+    
+    //
+    // Change the current waveform to the next in line, either forward or back,
+    // making sure to wrap around when necessary.
+    //
+    
+    if ((waveform == WaveformSine) && (change_value < 0))
+    {
+        waveform = WaveformCount - 1;
+    }
+    else if ((waveform == (WaveformCount - 1)) && (change_value > 0))
+    {
+        waveform = WaveformSine;
+    }
+    else
+    {
+        waveform = waveform + change_value;
+    }
+    
+    SelectWaveform(waveform);
+}
+#endif
+
+void StepSkew(int8_t change_value)
+{
+    int16_t skew = GetSkew() + (change_value * SKEW_ENCODER_STEP);
+    
+    //
+    // Move the break point along, stopping at either end; SetSkew() keeps it
+    // within 5% - 95% of the cycle. Turning all the way down gives a ramp down
+    // like triangle and a narrow pulse, all the way up a ramp up like
+    // triangle and a wide pulse.
+    //
+    
+    if (skew < 0x00)
+    {
+        skew = 0x00;
+    }
+    else if (skew > 0xff)
+    {
+        skew = 0xff;
+    }
+    
+    SetSkew(skew);
+}
+
+void StepMultiplier(int8_t change_value)
+{
+    uint8_t multiplier;
+    
+    //
+    // Change the current multiplier to the next in line, either forward or
+    // back, stopping at either end (no wrap-around). This (and the ability to
+    // reset by depressing for 2 seconds) should make it relatively easier to
+    // set the desired multiplier without having a visual indicator.
+    //
+    
+    multiplier = GetMultiplier();
+    
+    if ((multiplier == MultiplierWhole) && (change_value < 0))
+    {
+        multiplier = MultiplierWhole;
+    }
+    else if ((multiplier == MultiplierSixteenth) && (change_value > 0))
+    {
+        multiplier = MultiplierSixteenth;
+    }
+    else
+    {
+        multiplier = multiplier + change_value;
+    }
+    
+    //
+    // SelectMultiplier() only acts on an actual change.
+    //
+    
+    SelectMultiplier(multiplier);
+}
+
+#if ENABLE_TRANSFER_CURVE
+void StepTransferCurve(int8_t change_value)
+{
+    int8_t curve = GetTransferCurve() + change_value;
+    
+    //
+    // Change the transfer curve to the next in line, either forward or back,
+    // stopping at either end like the multiplier does; linear is always a
+    // reset (or a turn all the way down) away.
+    //
+    
+    if (curve < TransferCurveLinear)
+    {
+        curve = TransferCurveLinear;
+    }
+    else if (curve > (TransferCurveCount - 1))
+    {
+        curve = TransferCurveCount - 1;
+    }
+    
+    SelectTransferCurve(curve);
+}
+#endif
+
+#if ENABLE_SECOND_OUTPUT
+void StepSecondOutputOffset(int8_t change_value)
+{
+    //
+    // Move the second output's phase offset along, wrapping around; a full
+    // cycle either way comes back to where it started. Unsigned 8-bit math
+    // takes care of the wrapping.
+    //
+    
+    SetSecondOutputOffset(GetSecondOutputOffset() + (change_value * OFFSET_ENCODER_STEP));
+}
+#endif
+
+#if ENABLE_OUTPUT_SCALING
+uint8_t StepScaling(uint8_t value, int8_t change_value)
+{
+    int16_t scaled_value = value + (change_value * SCALING_ENCODER_STEP);
+    
+    //
+    // Move the output depth or level along, stopping at either end like the
+    // skew does.
+    //
+    
+    if (scaled_value < 0x00)
+    {
+        scaled_value = 0x00;
+    }
+    else if (scaled_value > 0xff)
+    {
+        scaled_value = 0xff;
+    }
+    
+    return scaled_value;
+}
+#endif
@@ -22,8 +22,9 @@
 // Email: harald (AT) website 
 //
 
-#ifndef __SWITCHING_H__
-#define __SWITCHING_H__
+
+#ifndef __SELECTION_H__
+#define __SELECTION_H__
 
 //
 // Millisecond count before a mode switch depress is interpreted as a reset.
@@ -35,14 +36,10 @@
 // Public function prototypes.
 //
 
-void InitializeSwitching();
-void DebounceSwitches();
-void CalculateSwitchStates();
-uint8_t SwitchWasClosed(uint8_t pins);
-uint8_t SwitchWasOpened(uint8_t pins);
-
+void InitializeSelection();
 void SetNextSelectionMode();
-void ModifyCurrentSelectionMode(int8_t change_value);
-void ResetCurrentSelectionMode();
+void QueueSelectionChange(int8_t change_value);
+void QueueSelectionReset();
+void UpdateSelection();
 
-#endif // __SWITCHING_H__
+#endif // __SELECTION_H__
@@ -0,0 +1,74 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+//
+// Board glue for the shared tap-tempo core (see common/). Selects the core
+// features this board uses, and hooks its pins into the tempo counting.
+//
+
+#include <avr/io.h>
+
+#include "main.h"
+#include "parameters.h"
+
+//
+// Core features. Skew, phase offset, morph, transfer curve and output scaling
+// are only included when a potentiometer has been assigned to them; see
+// parameters.h.
+//
+
+#define ENABLE_WAVEFORM_OUTPUT          1
+#define ENABLE_SINE_INTERPOLATION       1
+#define ENABLE_SMOOTH_RANDOM            1
+#define ENABLE_SKEW                     HAS_PARAMETER(PARAMETER_SKEW)
+#define ENABLE_PHASE_OFFSET             HAS_PARAMETER(PARAMETER_PHASE)
+#define ENABLE_WAVEFORM_MORPH           HAS_PARAMETER(PARAMETER_MORPH)
+#define ENABLE_TRANSFER_CURVE           HAS_PARAMETER(PARAMETER_CURVE)
+
+//
+// Core hooks.
+//
+
+#define SWITCH_PIN                      PINB
+#define LFO_OUTPUT_COMPARE              OCR0A
+#define PWM_TIMER_COUNT                 TCNT0
+#define PWM_TIMER_OVERFLOW_PENDING()    (TIFR & (1 << TOV0))
+#define TELEMETRY_PORT                  PORTB
+#define TELEMETRY_DDR                   DDRB
+
+#define TEMPO_COUNT_STARTED()           PORTB &= ~(1 << SYNC_OUT)   /* Pull low. */
+#define TEMPO_COUNT_STOPPED()           PORTB |= (1 << SYNC_OUT)    /* Pull high. */
+
+//
+// Shared state, defined in main.c.
+//
+
+extern volatile uint8_state_flags g_state;
+extern volatile uint16_t g_tempo_ms_count;
+
+#endif // __BOARD_H__
@@ -41,10 +41,16 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#include <util/atomic.h>
 
 #include "switching.h"
 #include "signaling.h"
+#include "critical.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "power.h"
+#include "supervision.h"
+#include "persistence.h"
+#include "parameters.h"
 #include "main.h"
 
 //
@@ -76,12 +82,16 @@
 //
 
 volatile uint8_state_flags g_state;
+volatile uint8_t g_has_pending_tick;
+volatile uint8_t g_is_counting_standby_time;
 
 volatile uint16_t g_tempo_ms_count;
+volatile uint16_t g_standby_ms_count;
 
 extern volatile uint8_t g_base_table_index;
 extern volatile uint32_t g_base_duty_cycle;
 extern volatile uint32_t g_base_phase_accumulator;
+extern volatile uint8_t g_supervision_sample_count;
 
 /*====== Public functions ===================================================== 
 =============================================================================*/
@@ -105,6 +115,14 @@ int main()
     
     PORTB = 0xff;
     
+#if ENABLE_TRACE
+    //
+    // Pick up the event trace from before the reset, if it survived.
+    //
+    
+    InitializeTrace(GetResetCause());
+#endif
+    
     //
     // Initialize switching.
     //
@@ -118,11 +136,33 @@ int main()
     SeedRandomNumberGenerator(0);
     UpdateRandomNumber();
     
+#if ENABLE_CUSTOM_WAVEFORM
+    //
+    // Pick up the custom waveform, from EEPROM if one has been uploaded,
+    // otherwise the one built in.
+    //
+    
+    LoadCustomWaveform();
+    
+#endif
     //
-    // Initialize signaling, including setting the default base tempo.
+    // Initialize signaling, including setting the default base tempo. The
+    // settings last committed to EEPROM take precedence over the defaults,
+    // and after anything but a power-on reset (e.g. the watchdog having
+    // kicked in) the settings from right before the reset take precedence
+    // over both, if still intact.
     //
     
     SetBaseTempo(DEFAULT_TEMPO);
+    InitializePersistence();
+    RecoverSettings();
+    
+    //
+    // Initialize the potentiometer parameters, including the output scaling
+    // table if any input has been assigned depth or offset.
+    //
+    
+    InitializeParameters();
     
     //
     // Disable USI to conserve power.
@@ -130,6 +170,20 @@ int main()
     
     PRR = (1 << PRUSI);
     
+#if ENABLE_TELEMETRY
+    //
+    // Set up the telemetry output pin.
+    //
+    
+    InitializeTelemetry();
+#endif
+    
+    //
+    // Set up idle sleep for the main loop.
+    //
+    
+    InitializePower();
+    
     //
     // Set up Timer0 in fast PWM mode with no prescaler and a non-inverted
     // compare.
@@ -186,6 +240,13 @@ int main()
     GIMSK |= (1 << PCIE);                   // Enable pin change interrupts.
 #endif
     
+    //
+    // Start the watchdog. From here on both the 1ms tick and the main loop
+    // have to keep checking in; see supervision.c.
+    //
+    
+    InitializeSupervision();
+    
     //
     // Enable global interrupts. No interrupts will happen without this,
     // regardless of individual flags set elsewhere.
@@ -200,7 +261,35 @@ int main()
     while (1)
     {
         //
-        // Continuously poll the tap input switch.
+        // Sleep until the next 1ms tick; see SleepUntilNextTick().
+        //
+        
+        SleepUntilNextTick();
+        
+#if ENABLE_TELEMETRY
+        //
+        // Queue up the next telemetry frame once the last one is out.
+        //
+        
+        UpdateTelemetry();
+#endif
+        
+        //
+        // Check in with the watchdog.
+        //
+        
+        SuperviseMainLoop();
+        
+        //
+        // Commit the settings to EEPROM once they've stopped changing.
+        //
+        
+        UpdatePersistence();
+        
+        //
+        // Poll the tap input switch, once per tick. The switch samples are
+        // only updated by the tick interrupt, so there's nothing new to find
+        // in between and no tap latency added by sleeping.
         //
         // Note: This routine has been moved to the main loop so as not to
         //       delay the interrupt processing unnecessarily. There is enough
@@ -218,6 +307,13 @@ int main()
         
         CalculateSwitchStates();
         
+        //
+        // Pick up any potentiometer changes flagged by the ADC interrupt that
+        // are too expensive to deal with there.
+        //
+        
+        UpdateParameters();
+        
         if (SwitchWasClosed(1 << TAP_IN))
         {
             //
@@ -226,7 +322,12 @@ int main()
             // switch.
             //  
             
-            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            TRACE(TraceEventTap, 0);
+            
+            g_standby_ms_count = 0;
+            g_is_counting_standby_time = 1;
+            
+            PROFILED_ATOMIC_BLOCK(CriticalSectionTap)
             {
                 //
                 // Always reset the output signal on a manual tap.
@@ -263,6 +364,31 @@ int main()
                 }
             }
         }
+        
+        if (SwitchWasOpened(1 << TAP_IN))
+        {
+            //
+            // Holding the tap switch for a few seconds before releasing it
+            // puts the unit in standby. Any tap (or sync pulse) wakes it up
+            // again with the same settings.
+            //
+            
+            g_is_counting_standby_time = 0;
+            
+            if (g_standby_ms_count >= STANDBY_MIN_TIME)
+            {
+                //
+                // Clear the count first. The press that wakes us up is never
+                // seen as a tap (see ResumeSwitching()), but its release is,
+                // and must not find the old count and go straight back into
+                // standby.
+                //
+                
+                g_standby_ms_count = 0;
+                
+                EnterStandby();
+            }
+        }
     }
 }
 
@@ -272,10 +398,14 @@ int main()
 // Frequency: 31.25kHz
 //
 
-ISR(TIM0_OVF_vect)
+ISR(TIM0_OVF_vect, ISR_FLATTEN)
 {
     uint8_t previous_base_table_index = g_base_table_index;
     
+    PWM_INTERRUPT_ENTERED();
+    
+    g_supervision_sample_count++;
+    
     //
     // Increase the phase accumulator by a given amount based on the required
     // output signal frequency. Then use the high 8 bits (0-255) of the phase
@@ -326,6 +456,8 @@ ISR(TIM0_OVF_vect)
     //
     
     PlotWaveform();
+    
+    PWM_INTERRUPT_LEAVING();
 }
 
 //
@@ -363,6 +495,43 @@ ISR(TIM1_COMPA_vect)
             TempoCountTimeout();
         }
     }
+    
+    //
+    // Count standby hold time, if applicable.
+    //
+    
+    if ((g_is_counting_standby_time == 1) && (g_standby_ms_count < 0xffff))
+    {
+        g_standby_ms_count++;
+    }
+    
+    //
+    // Check in with the watchdog, as long as the PWM interrupt is keeping up.
+    //
+    
+    SuperviseTick();
+    
+#if ENABLE_TRACE
+    //
+    // Keep the trace time stamps going.
+    //
+    
+    TRACE_TICK();
+#endif
+    
+#if ENABLE_TELEMETRY
+    //
+    // Next telemetry bit out.
+    //
+    
+    TransmitTelemetry();
+#endif
+    
+    //
+    // Let the main loop know there's a new tick to deal with.
+    //
+    
+    g_has_pending_tick = 1;
 }
 
 ISR(ADC_vect)
@@ -404,7 +573,7 @@ ISR(ADC_vect)
             // Sample was read from PB3; the waveform pin.
             //
             
-            SetWaveform(sample_value);
+            SetParameter(WAVEFORM_IN_PARAMETER, sample_value);
         }
         else    // MUX[0:0] == 0.
         {
@@ -412,14 +581,17 @@ ISR(ADC_vect)
             // Sample was read from PB4; the multiplier pin.
             //
             
-            SetMultiplier(sample_value);
+            SetParameter(MULTIPLIER_IN_PARAMETER, sample_value);
         }
         
         //
-        // Switch the ADC input channel.
+        // Switch the ADC input channel. With telemetry on PB4 is an output,
+        // so PB3 is the only input left to sample.
         //
         
+#if !ENABLE_TELEMETRY
         ADMUX ^= (1 << MUX0);   // Toggle between MUX[1:0] = 11 and MUX[1:0] = 10.
+#endif
         first_sampling = 1;
     }
 }
@@ -442,6 +614,8 @@ ISR(PCINT0_vect)
     {
         previous_sync_input = sync_input;
 
+        TRACE(TraceEventSync, (sync_input != 0));
+        
         //
         // Detect whether this is a falling or rising edge, and start or stop
         // the tempo counting accordingly.
@@ -465,4 +639,11 @@ ISR(PCINT0_vect)
         }
     }
 }
+#else
+//
+// Pin change interrupt handler. Without the external clock sync input this
+// is only used to wake up from standby (see EnterStandby()).
+//
+
+EMPTY_INTERRUPT(PCINT0_vect)
 #endif
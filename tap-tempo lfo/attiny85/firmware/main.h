@@ -40,7 +40,11 @@
 #define SYNC_OUT                		PB1     /* Base tempo indicator / sync output */
 #define TAP_IN                  		PB2     /* Tap switch input */
 #define WAVEFORM_IN             		PB3     /* Waveform selection ADC input */
+#if ENABLE_TELEMETRY
+#define TELEMETRY_OUT                   PB4     /* Telemetry serial output */
+#else
 #define MULTIPLIER_IN                   PB4     /* Multiplier selection ADC input */
+#endif
 
 #if ENABLE_EXT_CLK
 #define SYNC_IN                 		PB5     /* External sync signal interrupt input */
@@ -52,6 +56,14 @@
 // Various boolean flags wrapped up in a single byte to save space (not sure if
 // actually ends up taking less space when compiled).
 //
+// Note: The main loop updates these with a read-modify-write of the whole
+//       byte, not always inside an atomic block. The tick flag is set from the
+//       timer interrupt on every tick, and the standby flag is set and
+//       cleared by the main loop while the timer interrupt goes by it, so
+//       they're kept apart (g_has_pending_tick and
+//       g_is_counting_standby_time in main.c) rather than risk either one
+//       being lost.
+//
 
 typedef struct
 {
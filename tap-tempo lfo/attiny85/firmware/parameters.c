@@ -0,0 +1,307 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#include <avr/io.h>
+
+#include "main.h"
+#include "signaling.h"
+#include "parameters.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Give the ADC reading a slack of +/- 2 to allow for small fluctuations.
+// This comes out to 1 = 5V / 256 ~= 20mV --> i.e. +/- 40mV.
+//
+
+#define READING_SLACK                   2
+
+//
+// Local function prototypes.
+//
+
+uint8_t SelectionHasChanged(uint8_t *previous_value, uint8_t value);
+uint8_t ReadingToIndex(uint8_t value, uint8_t count);
+uint8_t ReadingHasChanged(uint8_t current_value, uint8_t value);
+
+//
+// Global variables.
+//
+
+#if HAS_PARAMETER(PARAMETER_MULTIPLIER)
+//
+// The multiplier selection, handed over from the ADC interrupt to
+// UpdateParameters(); see SetParameter().
+//
+
+volatile uint8_t g_multiplier_selection;
+volatile uint8_t g_multiplier_changed;
+#endif
+
+#if HAS_PARAMETER(PARAMETER_SKEW)
+//
+// Likewise the skew reading.
+//
+
+volatile uint8_t g_skew_reading = 0x80;
+volatile uint8_t g_skew_changed;
+#endif
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializeParameters()
+{
+    //
+    // The output (or morph) table has to be valid before the PWM interrupt
+    // starts reading from it.
+    //
+    
+#if ENABLE_WAVEFORM_MORPH
+    InitializeMorphTable();
+#elif ENABLE_OUTPUT_SCALING
+    InitializeOutputTable();
+#endif
+}
+
+void SetParameter(uint8_t parameter, uint8_t value)
+{
+    static uint8_t waveform_reading = 0x00;
+#if HAS_PARAMETER(PARAMETER_MULTIPLIER)
+    static uint8_t multiplier_reading = 0x00;
+#endif
+#if HAS_PARAMETER(PARAMETER_PHASE)
+    static uint8_t phase_reading = 0x00;
+#endif
+#if HAS_PARAMETER(PARAMETER_MORPH)
+    static uint8_t morph_reading = 0x00;
+#endif
+#if HAS_PARAMETER(PARAMETER_CURVE)
+    static uint8_t curve_reading = 0x00;
+#endif
+    
+    //
+    // Route an ADC reading to whatever parameter the input has been assigned.
+    // Note that this is called from the ADC interrupt, so anything expensive
+    // is only flagged here and left for UpdateParameters() in the main loop.
+    //
+    
+    switch (parameter)
+    {
+        case PARAMETER_WAVEFORM:
+        
+            if (SelectionHasChanged(&waveform_reading, value))
+            {
+                SelectWaveform(ReadingToIndex(value, WaveformCount));
+            }
+            break;
+        
+#if HAS_PARAMETER(PARAMETER_MULTIPLIER)
+        case PARAMETER_MULTIPLIER:
+        
+            //
+            // A new multiplier means a new duty cycle and phase, and with
+            // skew the same floating point divisions as below, so it's left
+            // for the main loop too.
+            //
+            
+            if (SelectionHasChanged(&multiplier_reading, value))
+            {
+                g_multiplier_selection = ReadingToIndex(value, MultiplierCount);
+                g_multiplier_changed = 1;
+            }
+            break;
+#endif
+        
+#if HAS_PARAMETER(PARAMETER_DEPTH)
+        case PARAMETER_DEPTH:
+        
+            if (ReadingHasChanged(GetOutputDepth(), value))
+            {
+                SetOutputDepth(value);
+            }
+            break;
+#endif
+        
+#if HAS_PARAMETER(PARAMETER_OFFSET)
+        case PARAMETER_OFFSET:
+        
+            if (ReadingHasChanged(GetOutputOffset(), value))
+            {
+                SetOutputOffset(value);
+            }
+            break;
+#endif
+        
+#if HAS_PARAMETER(PARAMETER_SKEW)
+        case PARAMETER_SKEW:
+        
+            //
+            // The skew takes two floating point divisions to work out (see
+            // SetSkew()), far too long for the ADC interrupt to hold up the
+            // PWM interrupt, so it's left for the main loop.
+            //
+            
+            if (ReadingHasChanged(g_skew_reading, value))
+            {
+                g_skew_reading = value;
+                g_skew_changed = 1;
+            }
+            break;
+#endif
+        
+#if HAS_PARAMETER(PARAMETER_PHASE)
+        case PARAMETER_PHASE:
+        
+            if (ReadingHasChanged(phase_reading, value))
+            {
+                phase_reading = value;
+                SetPhaseOffset(value);
+            }
+            break;
+#endif
+        
+#if HAS_PARAMETER(PARAMETER_MORPH)
+        case PARAMETER_MORPH:
+        
+            if (ReadingHasChanged(morph_reading, value))
+            {
+                morph_reading = value;
+                SetMorphPosition(value);
+            }
+            break;
+#endif
+        
+#if HAS_PARAMETER(PARAMETER_CURVE)
+        case PARAMETER_CURVE:
+        
+            if (SelectionHasChanged(&curve_reading, value))
+            {
+                SelectTransferCurve(ReadingToIndex(value, TransferCurveCount));
+            }
+            break;
+#endif
+        
+        default:
+        
+            break;
+    }
+}
+
+void UpdateParameters()
+{
+    //
+    // Apply a new multiplier selection or skew reading. Clearing the flag
+    // first means a reading arriving meanwhile is picked up on the next tick
+    // rather than lost.
+    //
+    
+#if HAS_PARAMETER(PARAMETER_MULTIPLIER)
+    if (g_multiplier_changed == 1)
+    {
+        g_multiplier_changed = 0;
+        SelectMultiplier(g_multiplier_selection);
+    }
+    
+#endif
+#if HAS_PARAMETER(PARAMETER_SKEW)
+    if (g_skew_changed == 1)
+    {
+        g_skew_changed = 0;
+        SetSkew(g_skew_reading);
+    }
+    
+#endif
+    //
+    // Carry on with the output (or morph) table, if it's being rebuilt after
+    // a depth, offset, transfer curve or morph change; a few entries per
+    // tick. With the morph in use the scaling is part of the morph table,
+    // and there's no output table of its own.
+    //
+    
+#if ENABLE_WAVEFORM_MORPH
+    UpdateMorphTable();
+#elif ENABLE_OUTPUT_SCALING
+    UpdateOutputTable();
+#endif
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+uint8_t SelectionHasChanged(uint8_t *previous_value, uint8_t value)
+{
+    uint8_t has_changed;
+    
+    //
+    // A discrete selection is compared against the previous reading, whether
+    // or not that reading was accepted.
+    //
+    
+    has_changed = (((int16_t)*previous_value > (int16_t)(value + READING_SLACK)) ||
+                   ((int16_t)*previous_value < (int16_t)(value - READING_SLACK)));
+    
+    *previous_value = value;
+    
+    return has_changed;
+}
+
+uint8_t ReadingToIndex(uint8_t value, uint8_t count)
+{
+    //
+    // Each selection is assigned an equal (almost) range of the possible
+    // 8-bit reading. Scaling the reading by the selection count and keeping
+    // the top byte gives the index, without any floating point math in the
+    // ADC interrupt, and the result never reaches count.
+    //
+    
+    return ((uint16_t)value * count) >> 8;
+}
+
+uint8_t ReadingHasChanged(uint8_t current_value, uint8_t value)
+{
+    //
+    // Unlike the discrete selections, a continuous parameter is compared
+    // against the value last accepted rather than the last reading, so a slow
+    // turn of the potentiometer can't creep past the slack unnoticed.
+    //
+    // Note: The very ends of the range are always accepted, otherwise the
+    //       slack would make it impossible to reach them.
+    //
+    
+    if (current_value == value)
+    {
+        return 0;
+    }
+    
+    if ((value == 0x00) || (value == 0xff))
+    {
+        return 1;
+    }
+    
+    return (((int16_t)current_value > (int16_t)(value + READING_SLACK)) ||
+            ((int16_t)current_value < (int16_t)(value - READING_SLACK)));
+}
@@ -0,0 +1,90 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __PARAMETERS_H__
+#define __PARAMETERS_H__
+
+//
+// Defines and structs.
+//
+
+//
+// Parameters that can be assigned to an ADC (potentiometer) input. The first
+// two are the discrete selections the inputs have always had, the transfer
+// curve is another discrete selection, and the rest are continuous and map
+// the full 8-bit reading onto the parameter range.
+//
+
+#define PARAMETER_WAVEFORM              0   /* Discrete waveform selection */
+#define PARAMETER_MULTIPLIER            1   /* Discrete multiplier selection */
+#define PARAMETER_DEPTH                 2   /* Output amplitude, 0 - 100% */
+#define PARAMETER_OFFSET                3   /* Output DC offset, bottom - top */
+#define PARAMETER_SKEW                  4   /* Waveform break point, 5 - 95% */
+#define PARAMETER_PHASE                 5   /* Phase offset, 0 - 360 degrees */
+#define PARAMETER_MORPH                 6   /* Waveform morph, sine - ramp down */
+#define PARAMETER_CURVE                 7   /* Discrete transfer curve selection */
+
+//
+// ADC input assignments. Normally set from the Makefile.
+//
+
+#ifndef WAVEFORM_IN_PARAMETER
+#define WAVEFORM_IN_PARAMETER           PARAMETER_WAVEFORM
+#endif
+
+#ifndef MULTIPLIER_IN_PARAMETER
+#define MULTIPLIER_IN_PARAMETER         PARAMETER_MULTIPLIER
+#endif
+
+#define HAS_PARAMETER(parameter)        ((WAVEFORM_IN_PARAMETER == (parameter)) || (MULTIPLIER_IN_PARAMETER == (parameter)))
+
+//
+// The morph replaces the discrete waveform selection altogether, so it can
+// only go on the waveform input.
+//
+
+#if MULTIPLIER_IN_PARAMETER == PARAMETER_MORPH
+#error "PARAMETER_MORPH replaces the waveform selection; assign it to WAVEFORM_IN_PARAMETER"
+#endif
+
+//
+// The output scaling stage (a lookup table between the waveform and the PWM
+// compare register) is only included when either depth or offset is in use,
+// since it costs half the available SRAM. With the morph in use the scaling
+// goes into the morph table instead, and there's no table of its own.
+// Whichever of depth/offset isn't assigned an input stays at its default;
+// see OUTPUT_DEFAULT_DEPTH in signaling.h.
+//
+
+#define ENABLE_OUTPUT_SCALING           (HAS_PARAMETER(PARAMETER_DEPTH) || HAS_PARAMETER(PARAMETER_OFFSET))
+
+//
+// Public function prototypes.
+//
+
+void InitializeParameters();
+void SetParameter(uint8_t parameter, uint8_t value);
+void UpdateParameters();
+
+#endif // __PARAMETERS_H__
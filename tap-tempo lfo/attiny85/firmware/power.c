@@ -0,0 +1,205 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "main.h"
+#include "signaling.h"
+#include "critical.h"
+#include "switching.h"
+#include "power.h"
+#include "supervision.h"
+#include "persistence.h"
+
+//
+// Global variables.
+//
+
+extern volatile uint8_t g_has_pending_tick;
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+void InitializePower()
+{
+    //
+    // Idle sleep only stops the CPU (and flash) clock. The timers, and with
+    // them the PWM output and the 1ms tick, keep running, and any interrupt
+    // wakes the CPU back up.
+    //
+    
+    set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+void SleepUntilNextTick()
+{
+    //
+    // Sleep until the 1ms timer interrupt has flagged a new tick. The PWM
+    // interrupt (and any pin change) will also wake the CPU, so keep going
+    // back to sleep until it's actually the tick.
+    //
+    // Note: Interrupts are kept disabled while checking the flag. The
+    //       instruction following sei() is always executed before any pending
+    //       interrupt, so a tick arriving between the check and sleep_cpu()
+    //       will wake us right back up rather than being slept through.
+    //
+    
+    cli();
+    
+    while (g_has_pending_tick == 0)
+    {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        cli();
+    }
+    
+    g_has_pending_tick = 0;
+    
+    sei();
+}
+
+void EnterStandby()
+{
+    uint8_t timer0_control;
+    uint8_t timer1_control;
+    uint8_t adc_control;
+    uint8_t pin_change_mask;
+    uint8_t interrupt_mask;
+    uint8_t power_reduction;
+    
+    //
+    // Discard any tempo count in progress (the switch press that got us here
+    // will have started one). Tempo, waveform and multiplier are all kept in
+    // SRAM, which is retained in power-down.
+    //
+    
+    PROFILED_ATOMIC_BLOCK(CriticalSectionPowerDown)
+    {
+        TempoCountTimeout();
+    }
+    
+    //
+    // Make sure any recent settings change makes it to EEPROM. There's no
+    // carrying on with a write once powered down.
+    //
+    
+    FlushPersistence();
+    
+    cli();
+    
+    //
+    // Remember the current timer, ADC and interrupt setup (see main()) so it
+    // can be put back exactly as it was.
+    //
+    
+    timer0_control = TCCR0B;
+    timer1_control = TCCR1;
+    adc_control = ADCSRA;
+    pin_change_mask = PCMSK;
+    interrupt_mask = GIMSK;
+    power_reduction = PRR;
+    
+    //
+    // Stop both timers and disconnect OC0A, so the LFO output can be held
+    // low, and turn off the ADC (it has to be disabled before being powered
+    // down). Also turn off the base tempo LED.
+    //
+    
+    TCCR0B = 0x00;
+    TCCR0A &= ~(1 << COM0A1);
+    TCCR1 = 0x00;
+    ADCSRA = 0x00;
+    
+    PRR = power_reduction | (1 << PRTIM0) | (1 << PRTIM1) | (1 << PRADC);
+    
+    PORTB &= ~(1 << LFO_OUT);   // Pull low.
+    PORTB |= (1 << SYNC_OUT);   // Pull high.
+    
+    //
+    // Wake up on a pin change on the tap input, or on the sync input if
+    // included (already set up in main()).
+    //
+    
+    PCMSK = pin_change_mask | (1 << TAP_IN);
+    GIFR = (1 << PCIF);
+    GIMSK = interrupt_mask | (1 << PCIE);
+    
+    //
+    // Stop the watchdog, or it would reset us out of power-down.
+    //
+    
+    SuspendSupervision();
+    
+    //
+    // Power down. Only a pin change (or reset) gets us out of this one.
+    //
+    
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+#if defined(BODS) && defined(BODSE)
+    sleep_bod_disable();
+#endif
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+    
+    //
+    // Awake again, and the pin change interrupt has already run. Put
+    // everything back the way it was, restarting both timers from zero.
+    //
+    
+    PCMSK = pin_change_mask;
+    GIMSK = interrupt_mask;
+    PRR = power_reduction;
+    
+    TCNT0 = 0x00;
+    TCNT1 = 0x00;
+    TCCR0A |= (1 << COM0A1);
+    TCCR0B = timer0_control;
+    TCCR1 = timer1_control;
+    ADCSRA = adc_control | (1 << ADSC);
+    
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    
+    //
+    // Restart the LFO output from the beginning of the waveform, so it's
+    // aligned with whatever woke us up; a tap, or an incoming sync pulse.
+    //
+    
+    ResetSignals();
+    ResumeSupervision();
+    
+    sei();
+    
+    //
+    // The tap switch may still be held down. Don't let it count as a tap.
+    //
+    
+    ResumeSwitching();
+}
@@ -0,0 +1,47 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __POWER_H__
+#define __POWER_H__
+
+//
+// Defines and structs.
+//
+
+//
+// Millisecond count the tap switch has to be held before being released for
+// the unit to go into standby.
+//
+
+#define STANDBY_MIN_TIME                3000
+
+//
+// Public function prototypes.
+//
+
+void InitializePower();
+void SleepUntilNextTick();
+void EnterStandby();
+
+#endif // __POWER_H__
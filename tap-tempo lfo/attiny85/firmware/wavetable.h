@@ -0,0 +1,25 @@
+//
+// Generated by tools/wavetable.c; do not edit. Regenerate with
+// "make tables", see the Makefile.
+//
+
+#ifndef __WAVETABLE_H__
+#define __WAVETABLE_H__
+
+#define WAVETABLE_INDEX_BITS            8
+#define WAVETABLE_DEPTH_BITS            8
+#define WAVETABLE_MAX                   255
+
+#define WAVETABLE_SINE_SIZE             65
+#define WAVETABLE_SINE_QUARTER          1
+
+static const uint8_t k_sine_table[WAVETABLE_SINE_SIZE] PROGMEM =
+{
+      0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+     10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+     37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+     79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+    128
+};
+
+#endif // __WAVETABLE_H__
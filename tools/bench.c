@@ -0,0 +1,808 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Interrupt benchmark. Runs on the build host, not the AVR: loads a firmware
+// .elf into simavr, plays a scripted set of taps, sync pulses, encoder turns
+// and potentiometer settings on its pins, and measures how many cycles each
+// interrupt handler takes. See "make bench" in the firmware Makefiles.
+//
+// Usage: bench board firmware.elf report [pwm_period [oscillators]]
+//
+//   board        attiny85, attiny84a or attiny861.
+//   report       Base name of the report; writes report.csv and report.json.
+//   pwm_period   Cycles per PWM timer overflow, default 256. The attiny861
+//                with LFO outputs (LFO_CHANNELS > 0) runs a 10-bit PWM, so
+//                1024; see "make bench".
+//   oscillators  Waveform oscillators the PWM interrupt renders each period
+//                (OSCILLATOR_COUNT, or LFO_CHANNELS on the attiny861),
+//                default 1; 0 for none.
+//
+// The script is split into phases (idle, tapping, sync input etc.), and each
+// phase gets min/avg/max cycles for every interrupt that ran, along with the
+// number of PWM overflows that were never serviced; i.e. how many output
+// samples were lost. The PWM interrupt also gets its avg/max cycles per
+// oscillator, i.e. spread evenly over them, to size up how many more fit
+// the PWM period.
+//
+// Note: An interrupt handler is timed from the moment simavr jumps to its
+//       vector until the RETI that sets the global interrupt flag again, so
+//       the push/pop prologue and epilogue are included. None of the
+//       handlers re-enable interrupts, so they can't nest.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <sim_io.h>
+#include <avr_ioport.h>
+#include <avr_adc.h>
+
+//
+// Defines and structs.
+//
+
+#define CLOCK_FREQUENCY                 8000000UL
+#define CYCLES_PER_MS                   (CLOCK_FREQUENCY / 1000)
+
+//
+// The PWM timer overflows every 256 cycles (8-bit fast PWM, no prescaler),
+// unless told otherwise on the command line; it depends on the build, not
+// just the board.
+//
+
+#define DEFAULT_PWM_PERIOD              256
+#define DEFAULT_OSCILLATOR_COUNT        1
+
+//
+// All supported parts have 8K of flash and single word (rjmp) vectors.
+//
+
+#define VECTOR_SIZE                     2
+#define MAX_VECTOR_COUNT                20
+
+#define SUPPLY_VOLTAGE                  5000    /* mV */
+
+//
+// Waveforms in a default build; sine, ramp up, ramp down, triangle, square,
+// random, smooth random and random walk (no custom waveform).
+//
+
+#define WAVEFORM_COUNT                  8
+
+#define MAX_EVENT_COUNT                 1024
+#define MAX_PHASE_COUNT                 16
+
+//
+// Switch and encoder timing, in milliseconds.
+//
+
+#define SWITCH_PRESS_TIME               40
+#define ENCODER_STEP_TIME               2
+
+typedef struct
+{
+    char port;      // 0 if the board doesn't have the pin.
+    uint8_t pin;
+} board_pin;
+
+typedef struct
+{
+    const char *name;
+    const char *mcu;
+    const char * const *vector_names;
+    uint8_t vector_count;
+    uint8_t pwm_vector;
+    board_pin tap_in;
+    board_pin sync_in;
+    board_pin mode_in;
+    board_pin rotary_a_in;
+    board_pin rotary_b_in;
+    board_pin input_select_in;
+    int8_t waveform_adc;        // -1 if none.
+    int8_t multiplier_adc;      // -1 if none.
+} board;
+
+typedef enum
+{
+    EventPin = 0,
+    EventAdc
+} event_type;
+
+typedef struct
+{
+    uint32_t time;      // ms
+    uint16_t order;     // Keeps events at the same time in script order.
+    event_type type;
+    board_pin pin;
+    uint8_t adc_channel;
+    uint32_t value;     // Pin level, or mV for the ADC.
+} event;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} isr_stats;
+
+typedef struct
+{
+    const char *name;
+    uint32_t start_time;    // ms
+    avr_cycle_count_t first_cycle;
+    avr_cycle_count_t last_cycle;
+    isr_stats isr[MAX_VECTOR_COUNT];
+} phase;
+
+//
+// Local function prototypes.
+//
+
+const board *FindBoard(const char *name);
+void BuildScript(const board *target);
+void AddPhase(uint32_t time, const char *name);
+void AddPinEvent(uint32_t time, board_pin pin, uint8_t level);
+void AddAdcEvent(uint32_t time, uint8_t channel, uint32_t millivolts);
+uint32_t PressSwitch(uint32_t time, board_pin pin);
+uint32_t TurnEncoder(uint32_t time, const board *target, int8_t detents);
+int CompareEvents(const void *a, const void *b);
+void ApplyEvent(avr_t *avr, const event *script_event);
+int RunScript(avr_t *avr, const board *target);
+uint32_t MissedOverflows(const phase *script_phase, const board *target);
+int WriteCsvReport(const char *path, const board *target);
+int WriteJsonReport(const char *path, const board *target, const char *firmware);
+
+//
+// Global variables.
+//
+
+static const char * const k_tiny85_vectors[] =
+{
+    "RESET", "INT0", "PCINT0", "TIM1_COMPA", "TIM1_OVF", "TIM0_OVF", "EE_RDY",
+    "ANA_COMP", "ADC", "TIM1_COMPB", "TIM0_COMPA", "TIM0_COMPB", "WDT",
+    "USI_START", "USI_OVF"
+};
+
+static const char * const k_tiny84_vectors[] =
+{
+    "RESET", "INT0", "PCINT0", "PCINT1", "WDT", "TIM1_CAPT", "TIM1_COMPA",
+    "TIM1_COMPB", "TIM1_OVF", "TIM0_COMPA", "TIM0_COMPB", "TIM0_OVF",
+    "ANA_COMP", "ADC", "EE_RDY", "USI_STR", "USI_OVF"
+};
+
+static const char * const k_tiny861_vectors[] =
+{
+    "RESET", "INT0", "PCINT", "TIMER1_COMPA", "TIMER1_COMPB", "TIMER1_OVF",
+    "TIMER0_OVF", "USI_START", "USI_OVF", "EE_RDY", "ANA_COMP", "ADC", "WDT",
+    "INT1", "TIMER0_COMPA", "TIMER0_COMPB", "TIMER1_CAPT", "TIMER1_COMPD",
+    "FAULT_PROTECTION"
+};
+
+#define VECTOR_COUNT(vectors)           (sizeof(vectors) / sizeof(vectors[0]))
+
+//
+// Pin assignments, as in each board's main.h. The attiny85 potentiometers
+// are PB3 (ADC3) and PB4 (ADC2).
+//
+
+static const board k_boards[] =
+{
+    {
+        "attiny85", "attiny85", k_tiny85_vectors, VECTOR_COUNT(k_tiny85_vectors), 5,
+        { 'B', 2 }, { 'B', 5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 },
+        3, 2
+    },
+    {
+        "attiny84a", "attiny84", k_tiny84_vectors, VECTOR_COUNT(k_tiny84_vectors), 11,
+        { 'A', 0 }, { 'B', 1 }, { 'A', 3 }, { 'A', 4 }, { 'A', 5 }, { 0, 0 },
+        -1, -1
+    },
+    {
+        "attiny861", "attiny861", k_tiny861_vectors, VECTOR_COUNT(k_tiny861_vectors), 5,
+        { 'A', 0 }, { 'A', 1 }, { 0, 0 }, { 'A', 6 }, { 'A', 7 }, { 'A', 4 },
+        -1, -1
+    }
+};
+
+#define BOARD_COUNT                     (sizeof(k_boards) / sizeof(k_boards[0]))
+
+static const char * const k_waveform_phases[WAVEFORM_COUNT] =
+{
+    "waveform 0", "waveform 1", "waveform 2", "waveform 3", "waveform 4",
+    "waveform 5", "waveform 6", "waveform 7"
+};
+
+static event g_events[MAX_EVENT_COUNT];
+static uint16_t g_event_count;
+
+static phase g_phases[MAX_PHASE_COUNT];
+static uint8_t g_phase_count;
+
+static uint32_t g_script_end_time;
+
+static uint32_t g_pwm_period = DEFAULT_PWM_PERIOD;
+static uint32_t g_oscillator_count = DEFAULT_OSCILLATOR_COUNT;
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+int main(int argc, char *argv[])
+{
+    const board *target;
+    elf_firmware_t firmware;
+    avr_t *avr;
+    char path[1024];
+    
+    if (argc >= 5)
+    {
+        g_pwm_period = atoi(argv[4]);
+    }
+    
+    if (argc >= 6)
+    {
+        g_oscillator_count = atoi(argv[5]);
+    }
+    
+    if ((argc < 4) || (argc > 6) || ((target = FindBoard(argv[1])) == NULL) || (g_pwm_period == 0))
+    {
+        fprintf(stderr, "Usage: %s board firmware.elf report [pwm_period [oscillators]]\n", argv[0]);
+        fprintf(stderr, "Boards: attiny85, attiny84a, attiny861.\n");
+        return 1;
+    }
+    
+    memset(&firmware, 0, sizeof(firmware));
+    if (elf_read_firmware(argv[2], &firmware) != 0)
+    {
+        fprintf(stderr, "%s: can't read '%s'\n", argv[0], argv[2]);
+        return 1;
+    }
+    
+    avr = avr_make_mcu_by_name(target->mcu);
+    if (avr == NULL)
+    {
+        fprintf(stderr, "%s: simavr doesn't know the %s\n", argv[0], target->mcu);
+        return 1;
+    }
+    
+    //
+    // The firmware doesn't carry the clock frequency or supply voltage, so
+    // set both to match the boards.
+    //
+    
+    avr_init(avr);
+    avr_load_firmware(avr, &firmware);
+    
+    avr->frequency = CLOCK_FREQUENCY;
+    avr->vcc = SUPPLY_VOLTAGE;
+    avr->avcc = SUPPLY_VOLTAGE;
+    avr->aref = SUPPLY_VOLTAGE;
+    
+    BuildScript(target);
+    
+    if (RunScript(avr, target) != 0)
+    {
+        fprintf(stderr, "%s: firmware stopped at cycle %llu\n", argv[0], (unsigned long long)avr->cycle);
+        return 1;
+    }
+    
+    snprintf(path, sizeof(path), "%s.csv", argv[3]);
+    if (WriteCsvReport(path, target) != 0)
+    {
+        fprintf(stderr, "%s: can't write '%s'\n", argv[0], path);
+        return 1;
+    }
+    
+    snprintf(path, sizeof(path), "%s.json", argv[3]);
+    if (WriteJsonReport(path, target, argv[2]) != 0)
+    {
+        fprintf(stderr, "%s: can't write '%s'\n", argv[0], path);
+        return 1;
+    }
+    
+    return 0;
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+const board *FindBoard(const char *name)
+{
+    unsigned int count;
+    
+    for (count = 0; count < BOARD_COUNT; count++)
+    {
+        if (strcmp(k_boards[count].name, name) == 0)
+        {
+            return &k_boards[count];
+        }
+    }
+    
+    return NULL;
+}
+
+void BuildScript(const board *target)
+{
+    uint32_t time;
+    int count;
+    
+    //
+    // Start with all switches open and the potentiometers centered, and give
+    // the firmware time to start up (EEPROM scan etc.) before measuring.
+    //
+    
+    AddPinEvent(0, target->tap_in, 1);
+    AddPinEvent(0, target->sync_in, 1);
+    AddPinEvent(0, target->mode_in, 1);
+    AddPinEvent(0, target->rotary_a_in, 1);
+    AddPinEvent(0, target->rotary_b_in, 1);
+    AddPinEvent(0, target->input_select_in, 1);
+    
+    if (target->waveform_adc >= 0)
+    {
+        AddAdcEvent(0, target->waveform_adc, 0);
+        AddAdcEvent(0, target->multiplier_adc, SUPPLY_VOLTAGE / 2);
+    }
+    
+    AddPhase(0, "startup");
+    
+    //
+    // Free running at the default tempo.
+    //
+    
+    time = 200;
+    AddPhase(time, "idle");
+    time += 1000;
+    
+    //
+    // Tapping a new tempo, 120 BPM.
+    //
+    
+    AddPhase(time, "tap");
+    for (count = 0; count < 4; count++)
+    {
+        PressSwitch(time + (count * 500), target->tap_in);
+    }
+    time += 2500;
+    
+    //
+    // Running off the sync input, 240 BPM. The clock needs its input source
+    // switched over first.
+    //
+    
+    if (target->sync_in.port != 0)
+    {
+        AddPhase(time, "sync");
+        AddPinEvent(time, target->input_select_in, 0);
+        for (count = 0; count < 8; count++)
+        {
+            PressSwitch(time + 50 + (count * 250), target->sync_in);
+        }
+        AddPinEvent(time + 2500, target->input_select_in, 1);
+        time += 2600;
+    }
+    
+    //
+    // Speed adjust with the encoder, fast enough to trigger the
+    // acceleration, then back again.
+    //
+    
+    if (target->rotary_a_in.port != 0)
+    {
+        AddPhase(time, "encoder");
+        time = TurnEncoder(time, target, 30);
+        time = TurnEncoder(time + 200, target, -30);
+        time += 500;
+    }
+    
+    //
+    // Every waveform in turn. The attiny84a always starts out in speed adjust
+    // mode, whatever its Makefile options (see InitializeSelection()), so one
+    // mode switch press moves on to waveform selection.
+    //
+    
+    if (target->mode_in.port != 0)
+    {
+        time = PressSwitch(time, target->mode_in) + 100;
+        AddPhase(time, k_waveform_phases[0]);
+        
+        for (count = 1; count < WAVEFORM_COUNT; count++)
+        {
+            time = TurnEncoder(time + 1000, target, 1);
+            AddPhase(time, k_waveform_phases[count]);
+        }
+        time += 1000;
+    }
+    
+    if (target->waveform_adc >= 0)
+    {
+        for (count = 0; count < WAVEFORM_COUNT; count++)
+        {
+            //
+            // Middle of each waveform's share of the potentiometer range.
+            //
+            
+            AddAdcEvent(time, target->waveform_adc, ((2 * count + 1) * SUPPLY_VOLTAGE) / (2 * WAVEFORM_COUNT));
+            AddPhase(time, k_waveform_phases[count]);
+            time += 1000;
+        }
+        
+        //
+        // Sweep both potentiometers end to end, to keep the ADC interrupt
+        // and the parameter updates busy.
+        //
+        
+        AddPhase(time, "pot sweep");
+        for (count = 0; count <= 50; count++)
+        {
+            AddAdcEvent(time + (count * 20), target->waveform_adc, (count * SUPPLY_VOLTAGE) / 50);
+            AddAdcEvent(time + (count * 20), target->multiplier_adc, SUPPLY_VOLTAGE - ((count * SUPPLY_VOLTAGE) / 50));
+        }
+        time += 1100;
+    }
+    
+    g_script_end_time = time;
+    
+    qsort(g_events, g_event_count, sizeof(event), CompareEvents);
+}
+
+void AddPhase(uint32_t time, const char *name)
+{
+    if (g_phase_count >= MAX_PHASE_COUNT)
+    {
+        fprintf(stderr, "bench: too many phases\n");
+        exit(1);
+    }
+    
+    memset(&g_phases[g_phase_count], 0, sizeof(phase));
+    g_phases[g_phase_count].name = name;
+    g_phases[g_phase_count].start_time = time;
+    g_phase_count++;
+}
+
+void AddPinEvent(uint32_t time, board_pin pin, uint8_t level)
+{
+    if (pin.port == 0)
+    {
+        return;
+    }
+    
+    if (g_event_count >= MAX_EVENT_COUNT)
+    {
+        fprintf(stderr, "bench: too many events\n");
+        exit(1);
+    }
+    
+    g_events[g_event_count].time = time;
+    g_events[g_event_count].order = g_event_count;
+    g_events[g_event_count].type = EventPin;
+    g_events[g_event_count].pin = pin;
+    g_events[g_event_count].value = level;
+    g_event_count++;
+}
+
+void AddAdcEvent(uint32_t time, uint8_t channel, uint32_t millivolts)
+{
+    if (g_event_count >= MAX_EVENT_COUNT)
+    {
+        fprintf(stderr, "bench: too many events\n");
+        exit(1);
+    }
+    
+    g_events[g_event_count].time = time;
+    g_events[g_event_count].order = g_event_count;
+    g_events[g_event_count].type = EventAdc;
+    g_events[g_event_count].adc_channel = channel;
+    g_events[g_event_count].value = millivolts;
+    g_event_count++;
+}
+
+uint32_t PressSwitch(uint32_t time, board_pin pin)
+{
+    //
+    // Switches and the sync input are all active low.
+    //
+    
+    AddPinEvent(time, pin, 0);
+    AddPinEvent(time + SWITCH_PRESS_TIME, pin, 1);
+    
+    return time + SWITCH_PRESS_TIME;
+}
+
+uint32_t TurnEncoder(uint32_t time, const board *target, int8_t detents)
+{
+    //
+    // One detent is a full quadrature cycle, starting and ending with both
+    // contacts open: AB = 11 -> 01 -> 00 -> 10 -> 11, or the other way
+    // around for the opposite direction.
+    //
+    
+    static const uint8_t k_sequence[4] = { 0x01, 0x00, 0x02, 0x03 };
+    uint8_t step;
+    uint8_t state;
+    
+    while (detents != 0)
+    {
+        for (step = 0; step < 4; step++)
+        {
+            state = (detents > 0) ? k_sequence[step] : k_sequence[(6 - step) % 4];
+            
+            time += ENCODER_STEP_TIME;
+            AddPinEvent(time, target->rotary_a_in, (state >> 1) & 0x01);
+            AddPinEvent(time, target->rotary_b_in, state & 0x01);
+        }
+        
+        detents += (detents > 0) ? -1 : 1;
+    }
+    
+    return time;
+}
+
+int CompareEvents(const void *a, const void *b)
+{
+    const event *first = a;
+    const event *second = b;
+    
+    if (first->time != second->time)
+    {
+        return (first->time < second->time) ? -1 : 1;
+    }
+    
+    return (int)first->order - (int)second->order;
+}
+
+void ApplyEvent(avr_t *avr, const event *script_event)
+{
+    if (script_event->type == EventPin)
+    {
+        avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(script_event->pin.port), script_event->pin.pin), script_event->value);
+    }
+    else
+    {
+        avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0 + script_event->adc_channel), script_event->value);
+    }
+}
+
+int RunScript(avr_t *avr, const board *target)
+{
+    avr_cycle_count_t end_cycle = (avr_cycle_count_t)g_script_end_time * CYCLES_PER_MS;
+    avr_cycle_count_t entry_cycle = 0;
+    uint16_t next_event = 0;
+    uint8_t current_phase = 0;
+    uint8_t was_enabled;
+    int8_t vector = -1;
+    isr_stats *stats;
+    uint32_t cycles;
+    int state;
+    
+    while (avr->cycle < end_cycle)
+    {
+        //
+        // Feed the script to the pins, and move on to the next phase when
+        // it's time.
+        //
+        
+        while ((next_event < g_event_count) &&
+               (((avr_cycle_count_t)g_events[next_event].time * CYCLES_PER_MS) <= avr->cycle))
+        {
+            ApplyEvent(avr, &g_events[next_event]);
+            next_event++;
+        }
+        
+        while (((current_phase + 1) < g_phase_count) &&
+               (((avr_cycle_count_t)g_phases[current_phase + 1].start_time * CYCLES_PER_MS) <= avr->cycle))
+        {
+            current_phase++;
+        }
+        
+        was_enabled = avr->sreg[S_I];
+        
+        state = avr_run(avr);
+        if ((state == cpu_Done) || (state == cpu_Crashed))
+        {
+            return 1;
+        }
+        
+        //
+        // simavr services an interrupt by clearing the global interrupt flag
+        // and jumping to the vector; the handler is done when RETI sets the
+        // flag again.
+        //
+        
+        if ((vector < 0) && was_enabled && !avr->sreg[S_I] &&
+            (avr->pc > 0) && (avr->pc < (target->vector_count * VECTOR_SIZE)))
+        {
+            vector = avr->pc / VECTOR_SIZE;
+            entry_cycle = avr->cycle;
+            
+            if (vector == target->pwm_vector)
+            {
+                if (g_phases[current_phase].first_cycle == 0)
+                {
+                    g_phases[current_phase].first_cycle = entry_cycle;
+                }
+                g_phases[current_phase].last_cycle = entry_cycle;
+            }
+        }
+        else if ((vector >= 0) && avr->sreg[S_I])
+        {
+            cycles = avr->cycle - entry_cycle;
+            stats = &g_phases[current_phase].isr[vector];
+            
+            if ((stats->count == 0) || (cycles < stats->min))
+            {
+                stats->min = cycles;
+            }
+            if (cycles > stats->max)
+            {
+                stats->max = cycles;
+            }
+            stats->total += cycles;
+            stats->count++;
+            
+            vector = -1;
+        }
+    }
+    
+    return 0;
+}
+
+uint32_t MissedOverflows(const phase *script_phase, const board *target)
+{
+    uint32_t expected;
+    uint32_t serviced = script_phase->isr[target->pwm_vector].count;
+    
+    //
+    // Between the first and the last PWM interrupt of the phase there should
+    // have been one per PWM period. Anything less means overflows that came
+    // and went while the interrupt was still pending.
+    //
+    
+    if (serviced < 2)
+    {
+        return 0;
+    }
+    
+    expected = ((script_phase->last_cycle - script_phase->first_cycle) + (g_pwm_period / 2)) / g_pwm_period + 1;
+    
+    return (expected > serviced) ? (expected - serviced) : 0;
+}
+
+int WriteCsvReport(const char *path, const board *target)
+{
+    FILE *report = fopen(path, "w");
+    const isr_stats *stats;
+    uint8_t phase_index;
+    uint8_t vector;
+    
+    if (report == NULL)
+    {
+        return 1;
+    }
+    
+    fprintf(report, "board,phase,isr,count,min_cycles,avg_cycles,max_cycles,missed_pwm_overflows,avg_cycles_per_oscillator,max_cycles_per_oscillator\n");
+    
+    for (phase_index = 0; phase_index < g_phase_count; phase_index++)
+    {
+        for (vector = 1; vector < target->vector_count; vector++)
+        {
+            stats = &g_phases[phase_index].isr[vector];
+            if (stats->count == 0)
+            {
+                continue;
+            }
+            
+            fprintf(report, "%s,%s,%s,%u,%u,%.1f,%u,", target->name, g_phases[phase_index].name, target->vector_names[vector],
+                    stats->count, stats->min, (double)stats->total / stats->count, stats->max);
+            
+            if (vector == target->pwm_vector)
+            {
+                fprintf(report, "%u", MissedOverflows(&g_phases[phase_index], target));
+            }
+            
+            fprintf(report, ",");
+            
+            if ((vector == target->pwm_vector) && (g_oscillator_count > 0))
+            {
+                fprintf(report, "%.1f,%.1f", (double)stats->total / stats->count / g_oscillator_count,
+                        (double)stats->max / g_oscillator_count);
+            }
+            else
+            {
+                fprintf(report, ",");
+            }
+            
+            fprintf(report, "\n");
+        }
+    }
+    
+    return (fclose(report) == 0) ? 0 : 1;
+}
+
+int WriteJsonReport(const char *path, const board *target, const char *firmware)
+{
+    FILE *report = fopen(path, "w");
+    const isr_stats *stats;
+    uint8_t phase_index;
+    uint8_t vector;
+    int is_first;
+    
+    if (report == NULL)
+    {
+        return 1;
+    }
+    
+    fprintf(report, "{\n");
+    fprintf(report, "  \"board\": \"%s\",\n", target->name);
+    fprintf(report, "  \"firmware\": \"%s\",\n", firmware);
+    fprintf(report, "  \"clock_frequency\": %lu,\n", CLOCK_FREQUENCY);
+    fprintf(report, "  \"pwm_period_cycles\": %u,\n", g_pwm_period);
+    fprintf(report, "  \"oscillators\": %u,\n", g_oscillator_count);
+    fprintf(report, "  \"phases\": [\n");
+    
+    for (phase_index = 0; phase_index < g_phase_count; phase_index++)
+    {
+        fprintf(report, "    {\n");
+        fprintf(report, "      \"name\": \"%s\",\n", g_phases[phase_index].name);
+        fprintf(report, "      \"start_ms\": %u,\n", g_phases[phase_index].start_time);
+        fprintf(report, "      \"missed_pwm_overflows\": %u,\n", MissedOverflows(&g_phases[phase_index], target));
+        fprintf(report, "      \"isrs\": [");
+        
+        is_first = 1;
+        for (vector = 1; vector < target->vector_count; vector++)
+        {
+            stats = &g_phases[phase_index].isr[vector];
+            if (stats->count == 0)
+            {
+                continue;
+            }
+            
+            fprintf(report, "%s\n        { \"name\": \"%s\", \"count\": %u, \"min\": %u, \"avg\": %.1f, \"max\": %u",
+                    is_first ? "" : ",", target->vector_names[vector],
+                    stats->count, stats->min, (double)stats->total / stats->count, stats->max);
+            
+            if ((vector == target->pwm_vector) && (g_oscillator_count > 0))
+            {
+                fprintf(report, ", \"avg_per_oscillator\": %.1f, \"max_per_oscillator\": %.1f",
+                        (double)stats->total / stats->count / g_oscillator_count, (double)stats->max / g_oscillator_count);
+            }
+            
+            fprintf(report, " }");
+            is_first = 0;
+        }
+        
+        fprintf(report, "%s]\n", is_first ? "" : "\n      ");
+        fprintf(report, "    }%s\n", ((phase_index + 1) < g_phase_count) ? "," : "");
+    }
+    
+    fprintf(report, "  ]\n");
+    fprintf(report, "}\n");
+    
+    return (fclose(report) == 0) ? 0 : 1;
+}
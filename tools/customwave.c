@@ -0,0 +1,380 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Custom waveform converter. Runs on the build host, not the AVR: reads a
+// waveform drawn as a list of levels from a CSV file and writes it out as
+// either the built-in custom waveform (a C header, customwave.h) or an
+// EEPROM image to upload on its own. See "make custom" and "make
+// custom-eeprom" in the LFO firmware Makefiles. It also does the custom
+// transfer curve (customcurve.h, "make custom-curve").
+//
+// Usage: customwave [-c | -x [-e eeprom_size]] csv
+//
+//   -c   Write the custom transfer curve header instead; see
+//        SelectTransferCurve() in common/signaling.c.
+//   -x   Write an Intel HEX EEPROM image instead of the header; the custom
+//        waveform record (see LoadCustomWaveform() in common/signaling.c)
+//        goes at the very end of the EEPROM.
+//   -e   EEPROM size in bytes, for -x. Default 512.
+//   csv  Levels, 0 - 255, separated by commas, spaces or line breaks; '#'
+//        starts a comment running to the end of the line. The levels are
+//        spread evenly over one cycle, starting at the beginning, and can be
+//        any number from 2 to 4096.
+//
+// The levels are resampled to CUSTOM_WAVEFORM_POINTS, with straight lines in
+// between and the last level joined back up with the first.
+//
+// A transfer curve isn't a cycle; the levels are the output for evenly spaced
+// input levels, the first for 0 and the last for 255, and are resampled to
+// CUSTOM_CURVE_POINTS with the ends left where they are.
+//
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+//
+// Defines and structs.
+//
+
+//
+// These have to match common/signaling.h and LoadCustomWaveform().
+//
+
+#define CUSTOM_WAVEFORM_POINTS          64
+#define CUSTOM_WAVEFORM_CRC_SEED        0xffff
+#define CUSTOM_CURVE_POINTS             256
+
+#define MIN_LEVEL_COUNT                 2
+#define MAX_LEVEL_COUNT                 4096
+
+#define DEFAULT_EEPROM_SIZE             512
+
+#define VALUES_PER_LINE                 16
+#define HEX_BYTES_PER_RECORD            16
+
+//
+// Local function prototypes.
+//
+
+int ReadLevels(FILE *csv, uint8_t *levels);
+void ResampleLevels(const uint8_t *levels, int level_count, uint8_t *points);
+void ResampleCurve(const uint8_t *levels, int level_count, uint8_t *points);
+uint16_t CalculateCrc(const uint8_t *points);
+void WriteHeader(const uint8_t *points, int point_count, const char *csv_name, int is_curve);
+void WriteEepromImage(const uint8_t *points, unsigned int eeprom_size);
+void PrintUsage(const char *program);
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+int main(int argc, char *argv[])
+{
+    uint8_t levels[MAX_LEVEL_COUNT];
+    uint8_t points[CUSTOM_CURVE_POINTS];
+    unsigned int eeprom_size = DEFAULT_EEPROM_SIZE;
+    int is_eeprom_image = 0;
+    int is_curve = 0;
+    int level_count;
+    int count;
+    FILE *csv;
+    
+    for (count = 1; (count < argc) && (argv[count][0] == '-'); count++)
+    {
+        if (strcmp(argv[count], "-x") == 0)
+        {
+            is_eeprom_image = 1;
+        }
+        else if (strcmp(argv[count], "-c") == 0)
+        {
+            is_curve = 1;
+        }
+        else if ((strcmp(argv[count], "-e") == 0) && (count + 1 < argc))
+        {
+            eeprom_size = atoi(argv[++count]);
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if ((count + 1 != argc) || (is_curve && is_eeprom_image) ||
+        (eeprom_size < CUSTOM_WAVEFORM_POINTS + 2) || (eeprom_size > 0x10000))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    
+    if ((csv = fopen(argv[count], "r")) == NULL)
+    {
+        fprintf(stderr, "%s: can't open '%s'\n", argv[0], argv[count]);
+        return 1;
+    }
+    
+    level_count = ReadLevels(csv, levels);
+    fclose(csv);
+    
+    if (level_count < 0)
+    {
+        fprintf(stderr, "%s: '%s' has something other than levels 0 - 255\n", argv[0], argv[count]);
+        return 1;
+    }
+    
+    if ((level_count < MIN_LEVEL_COUNT) || (level_count > MAX_LEVEL_COUNT))
+    {
+        fprintf(stderr, "%s: '%s' needs %d - %d levels, has %d\n", argv[0], argv[count], MIN_LEVEL_COUNT, MAX_LEVEL_COUNT, level_count);
+        return 1;
+    }
+    
+    if (is_curve)
+    {
+        ResampleCurve(levels, level_count, points);
+        WriteHeader(points, CUSTOM_CURVE_POINTS, argv[count], 1);
+    }
+    else if (is_eeprom_image)
+    {
+        ResampleLevels(levels, level_count, points);
+        WriteEepromImage(points, eeprom_size);
+    }
+    else
+    {
+        ResampleLevels(levels, level_count, points);
+        WriteHeader(points, CUSTOM_WAVEFORM_POINTS, argv[count], 0);
+    }
+    
+    return 0;
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+int ReadLevels(FILE *csv, uint8_t *levels)
+{
+    int level_count = 0;
+    int character;
+    long value = 0;
+    int is_in_value = 0;
+    
+    //
+    // A small hand-rolled scanner rather than fscanf(), so that anything
+    // that isn't a level, separator or comment is caught rather than quietly
+    // ending the list. Returns the number of levels, or -1 for rubbish.
+    //
+    
+    while (1)
+    {
+        character = fgetc(csv);
+        
+        if (isdigit(character))
+        {
+            if (!is_in_value)
+            {
+                value = 0;
+                is_in_value = 1;
+            }
+            
+            value = (value * 10) + (character - '0');
+            
+            if (value > 0xff)
+            {
+                return -1;
+            }
+            
+            continue;
+        }
+        
+        if (is_in_value)
+        {
+            if (level_count >= MAX_LEVEL_COUNT)
+            {
+                return MAX_LEVEL_COUNT + 1;
+            }
+            
+            levels[level_count++] = (uint8_t)value;
+            is_in_value = 0;
+        }
+        
+        if (character == EOF)
+        {
+            break;
+        }
+        
+        if (character == '#')
+        {
+            while (((character = fgetc(csv)) != EOF) && (character != '\n'))
+            {
+            }
+        }
+        else if ((character != ',') && (character != ';') && !isspace(character))
+        {
+            return -1;
+        }
+    }
+    
+    return level_count;
+}
+
+void ResampleLevels(const uint8_t *levels, int level_count, uint8_t *points)
+{
+    int count;
+    
+    for (count = 0; count < CUSTOM_WAVEFORM_POINTS; count++)
+    {
+        double position = ((double)count * level_count) / CUSTOM_WAVEFORM_POINTS;
+        int first = (int)floor(position);
+        double blend = position - first;
+        int next = (first + 1) % level_count;
+        
+        points[count] = (uint8_t)floor((levels[first] * (1.0 - blend)) + (levels[next] * blend) + 0.5);
+    }
+}
+
+void ResampleCurve(const uint8_t *levels, int level_count, uint8_t *points)
+{
+    int count;
+    
+    for (count = 0; count < CUSTOM_CURVE_POINTS; count++)
+    {
+        double position = ((double)count * (level_count - 1)) / (CUSTOM_CURVE_POINTS - 1);
+        int first = (int)floor(position);
+        double blend = position - first;
+        int next = (first + 1 < level_count) ? (first + 1) : first;
+        
+        points[count] = (uint8_t)floor((levels[first] * (1.0 - blend)) + (levels[next] * blend) + 0.5);
+    }
+}
+
+uint16_t CalculateCrc(const uint8_t *points)
+{
+    uint16_t crc = CUSTOM_WAVEFORM_CRC_SEED;
+    int count;
+    int bit;
+    
+    //
+    // Same as _crc16_update() in avr-libc (polynomial 0xa001).
+    //
+    
+    for (count = 0; count < CUSTOM_WAVEFORM_POINTS; count++)
+    {
+        crc ^= points[count];
+        
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ 0xa001) : (crc >> 1);
+        }
+    }
+    
+    return crc;
+}
+
+void WriteHeader(const uint8_t *points, int point_count, const char *csv_name, int is_curve)
+{
+    const char *name = is_curve ? "CUSTOMCURVE" : "CUSTOMWAVE";
+    int count;
+    
+    printf("//\n");
+    printf("// Generated by tools/customwave.c from %s; do not edit. Regenerate\n", csv_name);
+    printf("// with \"make %s\", see the Makefile.\n", is_curve ? "custom-curve" : "custom");
+    printf("//\n");
+    printf("\n");
+    printf("#ifndef __%s_H__\n", name);
+    printf("#define __%s_H__\n", name);
+    printf("\n");
+    printf("#define %s_%-*s%d\n", name, 31 - (int)strlen(name), "POINTS", point_count);
+    printf("\n");
+    printf("static const uint8_t k_custom_%s[%s_POINTS] PROGMEM =\n", is_curve ? "curve" : "waveform", name);
+    printf("{\n");
+    
+    for (count = 0; count < point_count; count++)
+    {
+        printf("%s%3u%s", ((count % VALUES_PER_LINE) == 0) ? "    " : " ", points[count],
+               (count + 1 < point_count) ? "," : "");
+        
+        if (((count + 1) % VALUES_PER_LINE) == 0)
+        {
+            printf("\n");
+        }
+    }
+    
+    printf("};\n");
+    printf("\n");
+    printf("#endif // __%s_H__\n", name);
+}
+
+void WriteEepromImage(const uint8_t *points, unsigned int eeprom_size)
+{
+    uint8_t record[CUSTOM_WAVEFORM_POINTS + 2];
+    uint16_t crc = CalculateCrc(points);
+    unsigned int address = eeprom_size - sizeof(record);
+    unsigned int offset;
+    unsigned int length;
+    unsigned int count;
+    uint8_t checksum;
+    
+    //
+    // The record as laid out in the AVR's EEPROM; the levels, then the CRC,
+    // low byte first.
+    //
+    
+    memcpy(record, points, CUSTOM_WAVEFORM_POINTS);
+    record[CUSTOM_WAVEFORM_POINTS] = crc & 0xff;
+    record[CUSTOM_WAVEFORM_POINTS + 1] = crc >> 8;
+    
+    for (offset = 0; offset < sizeof(record); offset += length)
+    {
+        length = sizeof(record) - offset;
+        
+        if (length > HEX_BYTES_PER_RECORD)
+        {
+            length = HEX_BYTES_PER_RECORD;
+        }
+        
+        checksum = length + ((address + offset) >> 8) + ((address + offset) & 0xff);
+        printf(":%02X%04X00", length, address + offset);
+        
+        for (count = 0; count < length; count++)
+        {
+            printf("%02X", record[offset + count]);
+            checksum += record[offset + count];
+        }
+        
+        printf("%02X\n", (uint8_t)-checksum);
+    }
+    
+    printf(":00000001FF\n");
+}
+
+void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-c | -x [-e eeprom_size]] csv\n", program);
+    fprintf(stderr, "  -c  Write the custom transfer curve header instead.\n");
+    fprintf(stderr, "  -x  Write an Intel HEX EEPROM image instead of the header.\n");
+    fprintf(stderr, "  -e  EEPROM size in bytes, for -x (default %d).\n", DEFAULT_EEPROM_SIZE);
+}
@@ -0,0 +1,85 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __HOST_AVR_IO_H__
+#define __HOST_AVR_IO_H__
+
+//
+// Host stand-in for <avr/io.h>, for building the tap-tempo core (common/) on
+// the build host; see tools/render.c. Only the registers the core and the
+// LFO board headers touch are here, and they're plain variables.
+//
+// Note: Exactly one source file has to define HOST_DEFINE_REGISTERS before
+//       including this, to get the variables defined rather than declared.
+//
+
+#include <stdint.h>
+
+//
+// Defines and structs.
+//
+
+#ifdef HOST_DEFINE_REGISTERS
+#define HOST_REGISTER(name)             volatile uint8_t name
+#else
+#define HOST_REGISTER(name)             extern volatile uint8_t name
+#endif
+
+#define PA0                             0
+#define PA1                             1
+#define PA2                             2
+#define PA3                             3
+#define PA4                             4
+#define PA5                             5
+#define PA6                             6
+#define PA7                             7
+
+#define PB0                             0
+#define PB1                             1
+#define PB2                             2
+#define PB3                             3
+#define PB4                             4
+#define PB5                             5
+#define PB6                             6
+#define PB7                             7
+
+#define TOV0                            1
+
+//
+// Global variables.
+//
+
+HOST_REGISTER(PINA);
+HOST_REGISTER(PORTA);
+HOST_REGISTER(DDRA);
+HOST_REGISTER(PINB);
+HOST_REGISTER(PORTB);
+HOST_REGISTER(DDRB);
+HOST_REGISTER(TCNT0);
+HOST_REGISTER(OCR0A);
+HOST_REGISTER(OCR0B);
+HOST_REGISTER(TIFR);
+HOST_REGISTER(TIFR0);
+
+#endif // __HOST_AVR_IO_H__
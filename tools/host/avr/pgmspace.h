@@ -0,0 +1,44 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __HOST_AVR_PGMSPACE_H__
+#define __HOST_AVR_PGMSPACE_H__
+
+//
+// Host stand-in for <avr/pgmspace.h>; see avr/io.h. There's only the one
+// address space on the host, so program memory reads are plain reads.
+//
+
+#include <stdint.h>
+
+//
+// Defines and structs.
+//
+
+#define PROGMEM
+
+#define pgm_read_byte(address)          (*(const uint8_t *)(address))
+#define pgm_read_word(address)          (*(const uint16_t *)(address))
+
+#endif // __HOST_AVR_PGMSPACE_H__
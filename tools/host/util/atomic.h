@@ -0,0 +1,45 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+#ifndef __HOST_UTIL_ATOMIC_H__
+#define __HOST_UTIL_ATOMIC_H__
+
+//
+// Host stand-in for <util/atomic.h>; see avr/io.h. The host build runs the
+// interrupt handlers' work from a single thread, so an atomic block is just
+// a block that runs once.
+//
+
+#include <stdint.h>
+
+//
+// Defines and structs.
+//
+
+#define ATOMIC_RESTORESTATE             0
+#define ATOMIC_FORCEON                  1
+
+#define ATOMIC_BLOCK(type)              for (uint8_t host_atomic_once = 1; host_atomic_once; host_atomic_once = 0)
+
+#endif // __HOST_UTIL_ATOMIC_H__
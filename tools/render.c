@@ -0,0 +1,833 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Golden output renderer. Runs on the build host, not the AVR: the tap-tempo
+// core (common/signaling.c) is built natively against a board's headers,
+// with tools/host standing in for the avr-libc ones, and driven the way the
+// PWM and tick interrupts drive it. See "make render" in the LFO firmware
+// Makefiles.
+//
+// Usage: render [-c csv_dir] [-w wav_dir] [-g golden_dir] [-a mV] [-p ms]
+//               [-f Hz]
+//        render -o cycles
+//
+//   -c  Write each case as csv_dir/<case>.csv (time_ms,level_mv).
+//   -w  Write each case as wav_dir/<case>.wav (16-bit mono).
+//   -g  Compare each case with golden_dir/<case>.csv, and exit with 1 if any
+//       of them doesn't match.
+//   -a  Amplitude tolerance for the comparison, default 40mV (2 LSB).
+//   -p  Phase tolerance for the comparison, default 2ms (1 sample).
+//   -f  Cutoff of the RC low-pass on the output, default 159Hz (10k and
+//       100nF).
+//   -o  Check a second oscillator against the first instead (see below),
+//       counting waveform cycles over the given number of base cycles.
+//
+// Every case is one waveform at one multiplier and base tempo, rendered for
+// five base cycles with the same script:
+//
+//   0     Settings applied, all phases reset (i.e. at power-up).
+//   1.5T  First tap, off the beat; StartTempoCount() and AlignWaveform().
+//   2.5T  Second tap, same tempo; StopTempoCount() and AlignWaveform().
+//   3.25T Next multiplier selected; SelectMultiplier().
+//
+// On top of that, the smooth random and random walk waveforms are rendered
+// once more (as "<waveform>_tap_<multiplier>_<tempo>") with each tap also
+// resetting the signals first, the way a manual tap does in main.c. That
+// puts ResetSignals() in the middle of a cycle, with a random segment under
+// way.
+//
+// The OCR0A value is run through the RC filter at the PWM sample rate, and
+// the filtered level (0 - 5V) is kept every RENDER_INTERVAL milliseconds.
+//
+// A rendered sample matches if it's within the amplitude tolerance of any
+// golden sample within the phase tolerance of it, and the other way around;
+// i.e. small timing shifts of an edge are let through, a different level or
+// a missing spike are not.
+//
+// The random waveforms are rendered too. The generator is the core's own
+// xorshift (see NextRandomNumber() in signaling.c), not the C library's, and
+// it's reseeded at the start of each case the way main() does at power-up, so
+// the sequence is the same every run and on every host.
+//
+// Built with OSCILLATOR_COUNT=2, the renderer can also start a second
+// oscillator with InitializeOscillator() and run it alongside the first,
+// which stays at 1:1. With the second one at 1:1 as well, both must complete
+// the same number of cycles; at half tempo, the second one half as many. No
+// board runs more than one oscillator yet, so this is the only thing keeping
+// the multi-oscillator side of the core honest.
+//
+// Note: Any feature a Makefile option turns on (e.g. depth and offset on the
+//       attiny85) is left out; the renderer always builds the board's default
+//       configuration.
+//
+
+#define HOST_DEFINE_REGISTERS
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "signaling.h"
+
+//
+// Defines and structs.
+//
+
+//
+// Same as PWM_SAMPLE_RATE in signaling.c; 8-bit fast PWM, no prescaler.
+//
+
+#define RENDER_SAMPLE_RATE              (CLOCK_FREQUENCY / 256)
+#define RENDER_TICK_RATE                1000
+#define RENDER_INTERVAL                 2       /* ms */
+
+#define SUPPLY_VOLTAGE                  5000    /* mV */
+
+#define DEFAULT_AMPLITUDE_TOLERANCE     40      /* mV */
+#define DEFAULT_PHASE_TOLERANCE         2       /* ms */
+#define DEFAULT_CUTOFF                  159.0   /* Hz */
+
+#define RENDER_BASE_CYCLES              5
+#define MAX_SAMPLE_COUNT                ((10000 * RENDER_BASE_CYCLES) / RENDER_INTERVAL + 1)
+
+#define MAX_PATH_LENGTH                 512
+
+#ifndef M_PI
+#define M_PI                            3.14159265358979323846
+#endif
+
+typedef struct
+{
+    uint8_t value;
+    const char *name;
+} render_setting;
+
+typedef struct
+{
+    uint16_t *samples;
+    unsigned int count;
+} render_output;
+
+typedef struct
+{
+    const char *program;
+    const char *csv_directory;
+    const char *wav_directory;
+    const char *golden_directory;
+    unsigned int amplitude_tolerance;
+    unsigned int phase_tolerance;
+} render_options;
+
+//
+// Local function prototypes.
+//
+
+void RenderCase(uint16_t tempo, uint8_t multiplier, uint8_t waveform, uint8_t is_resetting_on_tap, double cutoff, render_output *output);
+int CheckCase(const char *name, const render_output *output, render_output *golden, const render_options *options);
+void RunPwmInterrupt();
+void RunTickInterrupt();
+int WriteCsv(const char *path, const render_output *output);
+int WriteWav(const char *path, const render_output *output);
+int ReadCsv(const char *path, render_output *output);
+uint16_t CompareOutputs(const render_output *output, const render_output *golden, unsigned int window, unsigned int *worst_index);
+uint16_t FindClosestLevel(uint16_t level, const render_output *other, unsigned int index, unsigned int window);
+void WriteWord(FILE *file, uint16_t value);
+void WriteLong(FILE *file, uint32_t value);
+void PrintUsage(const char *program);
+
+#if OSCILLATOR_COUNT > 1
+unsigned int CheckOscillators(unsigned int base_cycles);
+uint8_t CheckOscillatorCase(uint16_t tempo, uint8_t multiplier, unsigned int base_cycles, unsigned int expected_cycles);
+#endif
+
+//
+// Global variables.
+//
+
+//
+// Shared state the board headers expect main.c to define.
+//
+
+volatile uint8_state_flags g_state;
+volatile uint16_t g_tempo_ms_count;
+
+extern volatile uint8_t g_base_table_index;
+extern volatile uint32_t g_base_duty_cycle;
+extern volatile uint32_t g_base_phase_accumulator;
+
+#if OSCILLATOR_COUNT > 1
+extern volatile lfo_oscillator g_oscillators[OSCILLATOR_COUNT];
+
+//
+// Stands in for the second oscillator's PWM compare register.
+//
+
+static volatile uint8_t g_second_output_compare;
+#endif
+
+//
+// The render matrix.
+//
+
+static const uint16_t k_render_tempos[] =
+{
+    125, 500
+};
+
+static const render_setting k_render_multipliers[] =
+{
+    { MultiplierWhole,          "whole" },
+    { MultiplierDottedQuarter,  "dotted_quarter" },
+    { MultiplierQuarter,        "quarter" },
+    { MultiplierSixteenth,      "sixteenth" }
+};
+
+static const render_setting k_render_waveforms[] =
+{
+    { WaveformSine,             "sine" },
+    { WaveformRampUp,           "ramp_up" },
+    { WaveformRampDown,         "ramp_down" },
+    { WaveformTriangle,         "triangle" },
+    { WaveformSquare,           "square" },
+    { WaveformRandom,           "random" },
+#if ENABLE_SMOOTH_RANDOM
+    { WaveformSmoothRandom,     "smooth_random" },
+    { WaveformRandomWalk,       "random_walk" }
+#endif
+};
+
+#if ENABLE_SMOOTH_RANDOM
+//
+// Rendered again with a signal reset on each tap; see above.
+//
+
+static const render_setting k_render_tap_waveforms[] =
+{
+    { WaveformSmoothRandom,     "smooth_random" },
+    { WaveformRandomWalk,       "random_walk" }
+};
+#endif
+
+#define ITEM_COUNT(items)               (sizeof(items) / sizeof(items[0]))
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+int main(int argc, char *argv[])
+{
+    render_options options;
+    double cutoff = DEFAULT_CUTOFF;
+    unsigned int oscillator_cycles = 0;
+    render_output output;
+    render_output golden;
+    char name[64];
+    unsigned int case_count = 0;
+    unsigned int failed_count = 0;
+    unsigned int tempo;
+    unsigned int multiplier;
+    unsigned int waveform;
+    int result;
+    int count;
+    
+    options.program = argv[0];
+    options.csv_directory = NULL;
+    options.wav_directory = NULL;
+    options.golden_directory = NULL;
+    options.amplitude_tolerance = DEFAULT_AMPLITUDE_TOLERANCE;
+    options.phase_tolerance = DEFAULT_PHASE_TOLERANCE;
+    
+    for (count = 1; count < argc; count++)
+    {
+        if ((argv[count][0] != '-') || (argv[count][1] == '\0') || (argv[count][2] != '\0') || (count + 1 >= argc))
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        
+        switch (argv[count++][1])
+        {
+            case 'c': options.csv_directory = argv[count]; break;
+            case 'w': options.wav_directory = argv[count]; break;
+            case 'g': options.golden_directory = argv[count]; break;
+            case 'a': options.amplitude_tolerance = atoi(argv[count]); break;
+            case 'p': options.phase_tolerance = atoi(argv[count]); break;
+            case 'f': cutoff = atof(argv[count]); break;
+            case 'o': oscillator_cycles = atoi(argv[count]); break;
+            default: PrintUsage(argv[0]); return 1;
+        }
+    }
+    
+    if (oscillator_cycles > 0)
+    {
+#if OSCILLATOR_COUNT > 1
+        return (CheckOscillators(oscillator_cycles) > 0) ? 1 : 0;
+#else
+        fprintf(stderr, "%s: -o needs a build with OSCILLATOR_COUNT=2\n", argv[0]);
+        return 1;
+#endif
+    }
+    
+    if ((cutoff <= 0.0) || ((options.csv_directory == NULL) && (options.wav_directory == NULL) && (options.golden_directory == NULL)))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    
+    output.samples = malloc(MAX_SAMPLE_COUNT * sizeof(uint16_t));
+    golden.samples = malloc(MAX_SAMPLE_COUNT * sizeof(uint16_t));
+    if ((output.samples == NULL) || (golden.samples == NULL))
+    {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+    
+    for (waveform = 0; waveform < ITEM_COUNT(k_render_waveforms); waveform++)
+    {
+        for (multiplier = 0; multiplier < ITEM_COUNT(k_render_multipliers); multiplier++)
+        {
+            for (tempo = 0; tempo < ITEM_COUNT(k_render_tempos); tempo++)
+            {
+                snprintf(name, sizeof(name), "%s_%s_%ums", k_render_waveforms[waveform].name,
+                         k_render_multipliers[multiplier].name, k_render_tempos[tempo]);
+                
+                RenderCase(k_render_tempos[tempo], k_render_multipliers[multiplier].value,
+                           k_render_waveforms[waveform].value, 0, cutoff, &output);
+                case_count++;
+                
+                if ((result = CheckCase(name, &output, &golden, &options)) < 0)
+                {
+                    return 1;
+                }
+                failed_count += result;
+            }
+        }
+    }
+    
+#if ENABLE_SMOOTH_RANDOM
+    for (waveform = 0; waveform < ITEM_COUNT(k_render_tap_waveforms); waveform++)
+    {
+        for (multiplier = 0; multiplier < ITEM_COUNT(k_render_multipliers); multiplier++)
+        {
+            for (tempo = 0; tempo < ITEM_COUNT(k_render_tempos); tempo++)
+            {
+                snprintf(name, sizeof(name), "%s_tap_%s_%ums", k_render_tap_waveforms[waveform].name,
+                         k_render_multipliers[multiplier].name, k_render_tempos[tempo]);
+                
+                RenderCase(k_render_tempos[tempo], k_render_multipliers[multiplier].value,
+                           k_render_tap_waveforms[waveform].value, 1, cutoff, &output);
+                case_count++;
+                
+                if ((result = CheckCase(name, &output, &golden, &options)) < 0)
+                {
+                    return 1;
+                }
+                failed_count += result;
+            }
+        }
+    }
+#endif
+    
+    if (options.golden_directory != NULL)
+    {
+        fprintf(stderr, "%u cases, %u failed\n", case_count, failed_count);
+    }
+    
+    free(output.samples);
+    free(golden.samples);
+    
+    return (failed_count > 0) ? 1 : 0;
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+void RenderCase(uint16_t tempo, uint8_t multiplier, uint8_t waveform, uint8_t is_resetting_on_tap, double cutoff, render_output *output)
+{
+    lfo_settings settings;
+    uint32_t sample_count;
+    uint32_t tick_time = 0;
+    uint32_t tick_count = 0;
+    uint32_t duration;
+    double alpha;
+    double level;
+    
+    //
+    // Start from scratch, as at power-up. Anything not set here (speed
+    // adjust, skew etc.) stays at its default.
+    //
+    
+    GetSettings(&settings);
+    settings.base_tempo = tempo;
+    settings.waveform = waveform;
+    settings.multiplier = multiplier;
+    
+    g_state.is_counting_tempo = 0;
+    g_tempo_ms_count = 0;
+    
+    //
+    // Restart the oscillator, along with any smooth random level left over
+    // from the case before, and reseed the random number generator.
+    //
+    
+    InitializeOscillator(0, &LFO_OUTPUT_COMPARE);
+    SeedRandomNumberGenerator(0);
+    UpdateRandomNumber();
+    
+    ApplySettings(&settings);
+    ResetSignals();
+    
+    //
+    // One-pole RC low-pass, stepped once per PWM period with the average
+    // level over that period. Settled at the first level, as if the output
+    // had been sitting there for a while.
+    //
+    
+    alpha = 1.0 - exp(-2.0 * M_PI * cutoff / RENDER_SAMPLE_RATE);
+    level = -1.0;
+    
+    duration = (uint32_t)tempo * RENDER_BASE_CYCLES;
+    output->count = 0;
+    
+    for (sample_count = 0; tick_count <= duration; sample_count++)
+    {
+        RunPwmInterrupt();
+        
+        if (level < 0.0)
+        {
+            level = ((LFO_OUTPUT_COMPARE + 1) * (double)SUPPLY_VOLTAGE) / 256;
+        }
+        level += alpha * ((((LFO_OUTPUT_COMPARE + 1) * (double)SUPPLY_VOLTAGE) / 256) - level);
+        
+        //
+        // Keep the 1kHz tick in step with the PWM periods, the way the two
+        // timers run side by side on the chip.
+        //
+        
+        tick_time += RENDER_TICK_RATE;
+        if (tick_time < RENDER_SAMPLE_RATE)
+        {
+            continue;
+        }
+        tick_time -= RENDER_SAMPLE_RATE;
+        
+        RunTickInterrupt();
+        
+        //
+        // The script, as the main loop would see it.
+        //
+        
+        if (tick_count == ((uint32_t)tempo * 3) / 2)
+        {
+            if (is_resetting_on_tap)
+            {
+                ResetSignals();
+            }
+            StartTempoCount();
+        }
+        else if (tick_count == ((uint32_t)tempo * 5) / 2)
+        {
+            if (is_resetting_on_tap)
+            {
+                ResetSignals();
+            }
+            StopTempoCount();
+        }
+        else if (tick_count == ((uint32_t)tempo * 13) / 4)
+        {
+            SelectMultiplier((multiplier + 1) % MultiplierCount);
+        }
+        
+        if ((tick_count % RENDER_INTERVAL) == 0)
+        {
+            output->samples[output->count++] = (uint16_t)(level + 0.5);
+        }
+        
+        tick_count++;
+    }
+}
+
+int CheckCase(const char *name, const render_output *output, render_output *golden, const render_options *options)
+{
+    char path[MAX_PATH_LENGTH];
+    unsigned int worst_index;
+    uint16_t worst_error;
+    
+    //
+    // Write out one rendered case as asked, and compare it with its golden
+    // file. Returns 1 if it doesn't match, and -1 if a file can't be written.
+    //
+    
+    if (options->csv_directory != NULL)
+    {
+        snprintf(path, sizeof(path), "%s/%s.csv", options->csv_directory, name);
+        if (WriteCsv(path, output) != 0)
+        {
+            fprintf(stderr, "%s: can't write '%s'\n", options->program, path);
+            return -1;
+        }
+    }
+    
+    if (options->wav_directory != NULL)
+    {
+        snprintf(path, sizeof(path), "%s/%s.wav", options->wav_directory, name);
+        if (WriteWav(path, output) != 0)
+        {
+            fprintf(stderr, "%s: can't write '%s'\n", options->program, path);
+            return -1;
+        }
+    }
+    
+    if (options->golden_directory == NULL)
+    {
+        return 0;
+    }
+    
+    snprintf(path, sizeof(path), "%s/%s.csv", options->golden_directory, name);
+    if (ReadCsv(path, golden) != 0)
+    {
+        printf("%-40s FAILED, no golden file '%s'\n", name, path);
+        return 1;
+    }
+    
+    if (golden->count != output->count)
+    {
+        printf("%-40s FAILED, %u samples, golden file has %u\n", name, output->count, golden->count);
+        return 1;
+    }
+    
+    worst_error = CompareOutputs(output, golden, options->phase_tolerance / RENDER_INTERVAL, &worst_index);
+    
+    if (worst_error > options->amplitude_tolerance)
+    {
+        printf("%-40s FAILED, off by %umV at %ums\n", name, worst_error, worst_index * RENDER_INTERVAL);
+        return 1;
+    }
+    
+    printf("%-40s ok (%umV)\n", name, worst_error);
+    
+    return 0;
+}
+
+void RunPwmInterrupt()
+{
+    uint8_t previous_base_table_index = g_base_table_index;
+    
+    //
+    // What the PWM interrupt in main.c does to the core; keep the two in step.
+    //
+    
+    g_base_phase_accumulator += g_base_duty_cycle;
+    g_base_table_index = (g_base_phase_accumulator & 0xff000000) >> 24;
+    
+#if ENABLE_QUEUED_SETTINGS
+    if (previous_base_table_index > g_base_table_index)
+    {
+        ApplyQueuedSettings();
+    }
+#else
+    (void)previous_base_table_index;
+#endif
+    
+    PlotWaveform();
+}
+
+void RunTickInterrupt()
+{
+    if (g_state.is_counting_tempo == 1)
+    {
+        g_tempo_ms_count++;
+        
+        if (g_tempo_ms_count > LFO_MIN_TEMPO)
+        {
+            TempoCountTimeout();
+        }
+    }
+}
+
+int WriteCsv(const char *path, const render_output *output)
+{
+    FILE *file;
+    unsigned int count;
+    
+    if ((file = fopen(path, "w")) == NULL)
+    {
+        return 1;
+    }
+    
+    fprintf(file, "time_ms,level_mv\n");
+    
+    for (count = 0; count < output->count; count++)
+    {
+        fprintf(file, "%u,%u\n", count * RENDER_INTERVAL, output->samples[count]);
+    }
+    
+    return fclose(file);
+}
+
+int WriteWav(const char *path, const render_output *output)
+{
+    FILE *file;
+    unsigned int count;
+    uint32_t data_size = output->count * 2;
+    
+    if ((file = fopen(path, "wb")) == NULL)
+    {
+        return 1;
+    }
+    
+    //
+    // Canonical 44 byte header; PCM, mono, 16 bits. 0V is full scale
+    // negative and 5V full scale positive.
+    //
+    
+    fwrite("RIFF", 1, 4, file);
+    WriteLong(file, 36 + data_size);
+    fwrite("WAVEfmt ", 1, 8, file);
+    WriteLong(file, 16);
+    WriteWord(file, 1);
+    WriteWord(file, 1);
+    WriteLong(file, 1000 / RENDER_INTERVAL);
+    WriteLong(file, (1000 / RENDER_INTERVAL) * 2);
+    WriteWord(file, 2);
+    WriteWord(file, 16);
+    fwrite("data", 1, 4, file);
+    WriteLong(file, data_size);
+    
+    for (count = 0; count < output->count; count++)
+    {
+        WriteWord(file, (uint16_t)(int16_t)((((int32_t)output->samples[count] * 65535) / SUPPLY_VOLTAGE) - 32768));
+    }
+    
+    return fclose(file);
+}
+
+int ReadCsv(const char *path, render_output *output)
+{
+    FILE *file;
+    unsigned int time;
+    unsigned int level;
+    
+    if ((file = fopen(path, "r")) == NULL)
+    {
+        return 1;
+    }
+    
+    //
+    // Skip the header line, then take the samples as they come; the time
+    // column is only there for plotting.
+    //
+    
+    fscanf(file, "%*[^\n]\n");
+    
+    output->count = 0;
+    while ((output->count < MAX_SAMPLE_COUNT) && (fscanf(file, "%u,%u\n", &time, &level) == 2))
+    {
+        output->samples[output->count++] = level;
+    }
+    
+    fclose(file);
+    
+    return 0;
+}
+
+uint16_t CompareOutputs(const render_output *output, const render_output *golden, unsigned int window, unsigned int *worst_index)
+{
+    uint16_t worst_error = 0;
+    uint16_t error;
+    unsigned int count;
+    
+    //
+    // Both ways round, so the rendered output has to stay close to the golden
+    // one, and it can't leave anything out either.
+    //
+    
+    *worst_index = 0;
+    
+    for (count = 0; count < output->count; count++)
+    {
+        error = FindClosestLevel(output->samples[count], golden, count, window);
+        if (error > worst_error)
+        {
+            worst_error = error;
+            *worst_index = count;
+        }
+        
+        error = FindClosestLevel(golden->samples[count], output, count, window);
+        if (error > worst_error)
+        {
+            worst_error = error;
+            *worst_index = count;
+        }
+    }
+    
+    return worst_error;
+}
+
+uint16_t FindClosestLevel(uint16_t level, const render_output *other, unsigned int index, unsigned int window)
+{
+    uint16_t closest = 0xffff;
+    unsigned int first = (index > window) ? (index - window) : 0;
+    unsigned int last = index + window;
+    unsigned int count;
+    
+    if (last >= other->count)
+    {
+        last = other->count - 1;
+    }
+    
+    for (count = first; count <= last; count++)
+    {
+        uint16_t error = abs((int)level - (int)other->samples[count]);
+        
+        if (error < closest)
+        {
+            closest = error;
+        }
+    }
+    
+    return closest;
+}
+
+void WriteWord(FILE *file, uint16_t value)
+{
+    fputc(value & 0xff, file);
+    fputc(value >> 8, file);
+}
+
+void WriteLong(FILE *file, uint32_t value)
+{
+    WriteWord(file, value & 0xffff);
+    WriteWord(file, value >> 16);
+}
+
+void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-c csv_dir] [-w wav_dir] [-g golden_dir] [-a mV] [-p ms] [-f Hz]\n", program);
+    fprintf(stderr, "       %s -o cycles\n", program);
+    fprintf(stderr, "  -c  Write the rendered cases as CSV.\n");
+    fprintf(stderr, "  -w  Write the rendered cases as WAV.\n");
+    fprintf(stderr, "  -g  Compare with the golden CSV files.\n");
+    fprintf(stderr, "  -a  Amplitude tolerance, mV (default %d).\n", DEFAULT_AMPLITUDE_TOLERANCE);
+    fprintf(stderr, "  -p  Phase tolerance, ms (default %d).\n", DEFAULT_PHASE_TOLERANCE);
+    fprintf(stderr, "  -f  RC low-pass cutoff, Hz (default %.0f).\n", DEFAULT_CUTOFF);
+    fprintf(stderr, "  -o  Check two oscillators over this many base cycles.\n");
+}
+
+#if OSCILLATOR_COUNT > 1
+unsigned int CheckOscillators(unsigned int base_cycles)
+{
+    unsigned int case_count = 0;
+    unsigned int failed_count = 0;
+    unsigned int tempo;
+    
+    //
+    // The second oscillator at 1:1 and at half tempo, against the first one
+    // at 1:1, for each of the render tempos.
+    //
+    
+    for (tempo = 0; tempo < ITEM_COUNT(k_render_tempos); tempo++)
+    {
+        failed_count += CheckOscillatorCase(k_render_tempos[tempo], MultiplierQuarter, base_cycles, base_cycles);
+        failed_count += CheckOscillatorCase(k_render_tempos[tempo], MultiplierHalf, base_cycles, base_cycles / 2);
+        case_count += 2;
+    }
+    
+    fprintf(stderr, "%u cases, %u failed\n", case_count, failed_count);
+    
+    return failed_count;
+}
+
+uint8_t CheckOscillatorCase(uint16_t tempo, uint8_t multiplier, unsigned int base_cycles, unsigned int expected_cycles)
+{
+    lfo_settings settings;
+    uint32_t sample_count;
+    uint32_t duration;
+    unsigned int cycles[2] = { 0, 0 };
+    uint8_t previous_table_index[2];
+    uint8_t count;
+    char name[64];
+    
+    //
+    // Both oscillators restarted from scratch, with the first one at 1:1 and
+    // the second one at the given multiplier, and all phases reset.
+    //
+    
+    InitializeOscillator(0, &LFO_OUTPUT_COMPARE);
+    InitializeOscillator(1, &g_second_output_compare);
+    
+    GetSettings(&settings);
+    settings.base_tempo = tempo;
+    settings.waveform = WaveformSine;
+    settings.multiplier = MultiplierQuarter;
+    
+    g_state.is_counting_tempo = 0;
+    g_tempo_ms_count = 0;
+    
+    ApplySettings(&settings);
+    SelectOscillatorMultiplier(1, multiplier);
+    ResetSignals();
+    
+    //
+    // Run for half a base cycle more than asked for, so a cycle completing
+    // right at the end isn't down to rounding in the duty cycles.
+    //
+    
+    duration = (((uint32_t)tempo * RENDER_SAMPLE_RATE) / RENDER_TICK_RATE) * base_cycles;
+    duration += ((uint32_t)tempo * RENDER_SAMPLE_RATE) / (2 * RENDER_TICK_RATE);
+    
+    for (sample_count = 0; sample_count < duration; sample_count++)
+    {
+        for (count = 0; count < 2; count++)
+        {
+            previous_table_index[count] = g_oscillators[count].table_index;
+        }
+        
+        RunPwmInterrupt();
+        
+        for (count = 0; count < 2; count++)
+        {
+            if (previous_table_index[count] > g_oscillators[count].table_index)
+            {
+                cycles[count]++;
+            }
+        }
+    }
+    
+    snprintf(name, sizeof(name), "oscillators_%s_%ums", (multiplier == MultiplierQuarter) ? "same" : "half", tempo);
+    
+    if ((cycles[0] != base_cycles) || (cycles[1] != expected_cycles))
+    {
+        printf("%-40s FAILED, %u and %u cycles, expected %u and %u\n", name, cycles[0], cycles[1], base_cycles, expected_cycles);
+        return 1;
+    }
+    
+    printf("%-40s ok (%u and %u cycles)\n", name, cycles[0], cycles[1]);
+    
+    return 0;
+}
+#endif
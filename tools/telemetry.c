@@ -0,0 +1,296 @@
+//
+// Tap-tempo LFO and clock for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Telemetry decoder. Runs on the build host, not the AVR: reads the raw
+// telemetry stream (see common/telemetry.h) as captured from the serial line
+// and writes it out as CSV, one line per frame, for plotting etc.
+//
+// Usage: telemetry [-t trace.csv] [capture]
+//
+//   -t        Write the event trace sent at startup (see common/trace.h), if
+//             any, to trace.csv; one line per event, oldest first.
+//   capture   File with the raw bytes received at 1000 baud 8N1. Standard
+//             input if not given.
+//
+// Frames with a bad checksum are skipped, and the decoder looks for the next
+// sync byte. Skipped and missing frames (gaps in the sequence numbers) are
+// counted on standard error at the end.
+//
+// Note: The time column is worked out from the sequence numbers; each frame
+//       takes 250ms on the line (25 bytes of 10 bits, 1ms per bit) and they
+//       go out back to back.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+//
+// Defines and structs.
+//
+
+//
+// These have to match common/telemetry.h.
+//
+
+#define TELEMETRY_SYNC                  0xa5
+#define TELEMETRY_TRACE_SYNC            0xa6
+#define TELEMETRY_CHECKSUM_SEED         0x5a
+#define TELEMETRY_FRAME_SIZE            25
+#define TELEMETRY_TRACE_RECORDS         4
+
+#define IS_SYNC(value)                  (((value) == TELEMETRY_SYNC) || ((value) == TELEMETRY_TRACE_SYNC))
+
+#define FRAME_TIME                      0.25    /* Seconds */
+
+//
+// Local function prototypes.
+//
+
+uint8_t CalculateChecksum(const uint8_t *frame);
+uint16_t GetWord(const uint8_t *frame);
+uint32_t GetLong(const uint8_t *frame);
+void PrintFrame(const uint8_t *frame, double time);
+void PrintTraceFrame(FILE *trace, const uint8_t *frame);
+
+//
+// Global variables.
+//
+
+//
+// Event names, in the order of TraceEvent in common/trace.h.
+//
+
+static const char * const k_trace_events[] =
+{
+    "none", "reset", "tap", "sync", "tempo", "base_reset", "align", "mode", "overrun"
+};
+
+#define TRACE_EVENT_COUNT               (sizeof(k_trace_events) / sizeof(k_trace_events[0]))
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+int main(int argc, char *argv[])
+{
+    FILE *capture = stdin;
+    FILE *trace = NULL;
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    unsigned int length = 0;
+    unsigned long frame_count = 0;
+    unsigned long bad_count = 0;
+    unsigned long missing_count = 0;
+    unsigned long frame_number = 0;
+    uint8_t previous_sequence = 0;
+    unsigned int count;
+    int argument = 1;
+    int value;
+    
+    if ((argc > 2) && (strcmp(argv[1], "-t") == 0))
+    {
+        if ((trace = fopen(argv[2], "w")) == NULL)
+        {
+            fprintf(stderr, "%s: can't write '%s'\n", argv[0], argv[2]);
+            return 1;
+        }
+        
+        fprintf(trace, "position,time_ms,event,value\n");
+        argument = 3;
+    }
+    
+    if ((argc > (argument + 1)) || ((argc > argument) && (argv[argument][0] == '-')))
+    {
+        fprintf(stderr, "Usage: %s [-t trace.csv] [capture]\n", argv[0]);
+        return 1;
+    }
+    
+    if ((argc == (argument + 1)) && ((capture = fopen(argv[argument], "rb")) == NULL))
+    {
+        fprintf(stderr, "%s: can't open '%s'\n", argv[0], argv[argument]);
+        return 1;
+    }
+    
+    printf("time_s,sequence,tempo_ms,speed_adjust_ms,base_increment,increment,base_phase,phase,waveform,multiplier,sync_error_ms,late_samples,missed_samples\n");
+    
+    while ((value = fgetc(capture)) != EOF)
+    {
+        //
+        // Wait for a sync byte, then collect a whole frame.
+        //
+        
+        if ((length == 0) && !IS_SYNC(value))
+        {
+            continue;
+        }
+        
+        frame[length++] = value;
+        
+        if (length < TELEMETRY_FRAME_SIZE)
+        {
+            continue;
+        }
+        
+        if (CalculateChecksum(frame) != frame[TELEMETRY_FRAME_SIZE - 1])
+        {
+            //
+            // Not a frame after all, or a damaged one. Look for the next sync
+            // byte within what we've got, rather than throwing it all away.
+            //
+            
+            bad_count++;
+            
+            for (count = 1; count < TELEMETRY_FRAME_SIZE; count++)
+            {
+                if (IS_SYNC(frame[count]))
+                {
+                    break;
+                }
+            }
+            
+            length = TELEMETRY_FRAME_SIZE - count;
+            for (value = 0; value < (int)length; value++)
+            {
+                frame[value] = frame[count + value];
+            }
+            
+            continue;
+        }
+        
+        if (frame_count > 0)
+        {
+            frame_number += (uint8_t)(frame[1] - previous_sequence);
+            missing_count += (uint8_t)(frame[1] - previous_sequence - 1);
+        }
+        previous_sequence = frame[1];
+        frame_count++;
+        
+        if (frame[0] == TELEMETRY_SYNC)
+        {
+            PrintFrame(frame, frame_number * FRAME_TIME);
+        }
+        else if (trace != NULL)
+        {
+            PrintTraceFrame(trace, frame);
+        }
+        
+        length = 0;
+    }
+    
+    fprintf(stderr, "%lu frames, %lu skipped (bad checksum), %lu missing\n", frame_count, bad_count, missing_count);
+    
+    if (capture != stdin)
+    {
+        fclose(capture);
+    }
+    
+    if (trace != NULL)
+    {
+        fclose(trace);
+    }
+    
+    return 0;
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+uint8_t CalculateChecksum(const uint8_t *frame)
+{
+    uint8_t count;
+    uint8_t checksum = TELEMETRY_CHECKSUM_SEED;
+    
+    for (count = 0; count < (TELEMETRY_FRAME_SIZE - 1); count++)
+    {
+        checksum = ((checksum << 1) | (checksum >> 7)) + frame[count];
+    }
+    
+    return checksum;
+}
+
+uint16_t GetWord(const uint8_t *frame)
+{
+    return frame[0] | (frame[1] << 8);
+}
+
+uint32_t GetLong(const uint8_t *frame)
+{
+    return GetWord(&frame[0]) | ((uint32_t)GetWord(&frame[2]) << 16);
+}
+
+void PrintFrame(const uint8_t *frame, double time)
+{
+    printf("%.2f,%u,%u,%d,%lu,%lu,%u,%u,", time, frame[1], GetWord(&frame[2]), (int16_t)GetWord(&frame[4]),
+           (unsigned long)GetLong(&frame[6]), (unsigned long)GetLong(&frame[10]), frame[14], frame[15]);
+    
+    //
+    // Leave out what the board doesn't have.
+    //
+    
+    if (frame[16] != 0xff)
+    {
+        printf("%u", frame[16]);
+    }
+    printf(",");
+    
+    if (frame[17] != 0xff)
+    {
+        printf("%u", frame[17]);
+    }
+    
+    printf(",%d,%u,%u\n", (int16_t)GetWord(&frame[18]), GetWord(&frame[20]), GetWord(&frame[22]));
+}
+
+void PrintTraceFrame(FILE *trace, const uint8_t *frame)
+{
+    const uint8_t *record;
+    uint8_t count;
+    
+    for (count = 0; count < TELEMETRY_TRACE_RECORDS; count++)
+    {
+        record = &frame[3 + (count * 5)];
+        
+        //
+        // Skip the slots that haven't been used yet.
+        //
+        
+        if (record[2] == 0)
+        {
+            continue;
+        }
+        
+        fprintf(trace, "%u,%u,", frame[2] + count, GetWord(&record[0]));
+        
+        if (record[2] < TRACE_EVENT_COUNT)
+        {
+            fprintf(trace, "%s", k_trace_events[record[2]]);
+        }
+        else
+        {
+            fprintf(trace, "%u", record[2]);
+        }
+        
+        fprintf(trace, ",%u\n", GetWord(&record[3]));
+    }
+}
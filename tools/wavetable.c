@@ -0,0 +1,333 @@
+//
+// Tap-tempo LFO for 8-bit AVR.
+// 
+// Copyright (C) 2013-2016 Harald Sabro
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact info
+// ------------
+// Website: sabrotone.com
+// Email: harald (AT) website 
+//
+
+//
+// Wave table generator. Runs on the build host, not the AVR, and writes a C
+// header with one or more waveform tables to stdout. See "make tables" in the
+// LFO firmware Makefiles.
+//
+// Usage: wavetable [-b index_bits] [-d depth_bits] [-f] [-c] shape [shape ...]
+//
+//   -b  Table resolution; the table covers a full cycle in 2^index_bits
+//       steps. 2 - 12, default 8.
+//   -d  Amplitude depth; each entry is 0 - (2^depth_bits - 1). 1 - 16,
+//       default 8.
+//   -f  Always write full tables, i.e. no quarter-wave compression.
+//   -c  Write transfer curves (curves.h) rather than waveforms; see Note 3.
+//
+// Shapes: sine, triangle, exp (exponential rise), log (logarithmic rise).
+//
+// Note: All shapes start at the bottom of the cycle, matching the phase of
+//       the waveforms calculated in the firmware.
+//
+// Note 2: Shapes that are symmetric around both the quarter and the half
+//         cycle (sine, triangle) are compressed by default, and only the
+//         first quarter plus one is written. The rest of the cycle is found
+//         as
+//
+//           0     - N/4   : table[i]
+//           N/4   - N/2   : max - table[N/2 - i]
+//           N/2   - 3N/4  : max - table[i - N/2]
+//           3N/4  - N     : table[N - i]
+//
+//         (N = 2^index_bits), with the end points belonging to the first and
+//         last quarter. The table values are worked out for the first quarter
+//         only, so the reconstructed cycle is exactly symmetric.
+//
+// Note 3: A transfer curve maps an output level onto another (see
+//         SelectTransferCurve() in common/signaling.c), so rather than a
+//         cycle it spans the level range end to end; the first entry is the
+//         bottom of the shape and the last entry the top. Curves are always
+//         written in full, and under CURVE_ rather than WAVETABLE_ names.
+//
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+//
+// Defines and structs.
+//
+
+#define MIN_INDEX_BITS                  2
+#define MAX_INDEX_BITS                  12
+#define MIN_DEPTH_BITS                  1
+#define MAX_DEPTH_BITS                  16
+
+#define DEFAULT_INDEX_BITS              8
+#define DEFAULT_DEPTH_BITS              8
+
+#define VALUES_PER_LINE                 16
+
+//
+// Round to nearest, with a little extra so that values that should come out
+// at exactly .5 (e.g. the sine midpoint) aren't rounded down by floating
+// point error.
+//
+
+#define ROUNDING_OFFSET                 (0.5 + 1e-9)
+
+#ifndef M_PI
+#define M_PI                            3.14159265358979323846
+#endif
+
+//
+// Curvature of the exponential and logarithmic shapes; the ratio between the
+// steepest and the flattest part of the curve.
+//
+
+#define CURVE_RATIO                     64.0
+
+typedef double (*shape_function)(double position);
+
+typedef struct
+{
+    const char *name;
+    shape_function function;
+    int is_symmetric;
+} shape;
+
+//
+// Local function prototypes.
+//
+
+double SineShape(double position);
+double TriangleShape(double position);
+double ExpShape(double position);
+double LogShape(double position);
+const shape *FindShape(const char *name);
+void WriteTable(const shape *table_shape, int index_bits, int depth_bits, int is_compressed, int is_curve);
+void PrintUsage(const char *program);
+
+//
+// Global variables.
+//
+
+static const shape k_shapes[] =
+{
+    { "sine",       SineShape,      1 },
+    { "triangle",   TriangleShape,  1 },
+    { "exp",        ExpShape,       0 },
+    { "log",        LogShape,       0 }
+};
+
+#define SHAPE_COUNT                     (sizeof(k_shapes) / sizeof(k_shapes[0]))
+
+/*====== Public functions ===================================================== 
+=============================================================================*/
+
+int main(int argc, char *argv[])
+{
+    int index_bits = DEFAULT_INDEX_BITS;
+    int depth_bits = DEFAULT_DEPTH_BITS;
+    int is_full = 0;
+    int is_curve = 0;
+    const char *prefix;
+    const char *guard;
+    int first_shape;
+    int count;
+    
+    //
+    // Parse options, then make sure every shape is known before writing
+    // anything, so a typo doesn't leave half a header behind.
+    //
+    
+    for (count = 1; (count < argc) && (argv[count][0] == '-'); count++)
+    {
+        if ((strcmp(argv[count], "-b") == 0) && (count + 1 < argc))
+        {
+            index_bits = atoi(argv[++count]);
+        }
+        else if ((strcmp(argv[count], "-d") == 0) && (count + 1 < argc))
+        {
+            depth_bits = atoi(argv[++count]);
+        }
+        else if (strcmp(argv[count], "-f") == 0)
+        {
+            is_full = 1;
+        }
+        else if (strcmp(argv[count], "-c") == 0)
+        {
+            is_curve = 1;
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    first_shape = count;
+    
+    if ((first_shape >= argc) ||
+        (index_bits < MIN_INDEX_BITS) || (index_bits > MAX_INDEX_BITS) ||
+        (depth_bits < MIN_DEPTH_BITS) || (depth_bits > MAX_DEPTH_BITS))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    
+    for (count = first_shape; count < argc; count++)
+    {
+        if (FindShape(argv[count]) == NULL)
+        {
+            fprintf(stderr, "%s: unknown shape '%s'\n", argv[0], argv[count]);
+            return 1;
+        }
+    }
+    
+    prefix = is_curve ? "CURVE" : "WAVETABLE";
+    guard = is_curve ? "__CURVES_H__" : "__WAVETABLE_H__";
+    
+    printf("//\n");
+    printf("// Generated by tools/wavetable.c; do not edit. Regenerate with\n");
+    printf("// \"make tables\", see the Makefile.\n");
+    printf("//\n");
+    printf("\n");
+    printf("#ifndef %s\n", guard);
+    printf("#define %s\n", guard);
+    printf("\n");
+    printf("#define %s_%-*s%d\n", prefix, 31 - (int)strlen(prefix), "INDEX_BITS", index_bits);
+    printf("#define %s_%-*s%d\n", prefix, 31 - (int)strlen(prefix), "DEPTH_BITS", depth_bits);
+    printf("#define %s_%-*s%lu\n", prefix, 31 - (int)strlen(prefix), "MAX", (1UL << depth_bits) - 1);
+    
+    for (count = first_shape; count < argc; count++)
+    {
+        const shape *table_shape = FindShape(argv[count]);
+        
+        WriteTable(table_shape, index_bits, depth_bits, table_shape->is_symmetric && !is_full && !is_curve, is_curve);
+    }
+    
+    printf("\n");
+    printf("#endif // %s\n", guard);
+    
+    return 0;
+}
+
+/*====== Local functions ====================================================== 
+=============================================================================*/
+
+//
+// Shape functions. Each takes a position within the cycle (0.0 - 1.0) and
+// returns a level (0.0 - 1.0).
+//
+
+double SineShape(double position)
+{
+    return (1.0 - cos(2.0 * M_PI * position)) / 2.0;
+}
+
+double TriangleShape(double position)
+{
+    return (position < 0.5) ? (position * 2.0) : (2.0 - (position * 2.0));
+}
+
+double ExpShape(double position)
+{
+    return (pow(CURVE_RATIO, position) - 1.0) / (CURVE_RATIO - 1.0);
+}
+
+double LogShape(double position)
+{
+    return log(1.0 + (position * (CURVE_RATIO - 1.0))) / log(CURVE_RATIO);
+}
+
+const shape *FindShape(const char *name)
+{
+    unsigned int count;
+    
+    for (count = 0; count < SHAPE_COUNT; count++)
+    {
+        if (strcmp(k_shapes[count].name, name) == 0)
+        {
+            return &k_shapes[count];
+        }
+    }
+    
+    return NULL;
+}
+
+void WriteTable(const shape *table_shape, int index_bits, int depth_bits, int is_compressed, int is_curve)
+{
+    unsigned long resolution = 1UL << index_bits;
+    unsigned long span = is_curve ? (resolution - 1) : resolution;
+    const char *prefix = is_curve ? "CURVE" : "WAVETABLE";
+    unsigned long maximum = (1UL << depth_bits) - 1;
+    unsigned long size = is_compressed ? ((resolution / 4) + 1) : resolution;
+    unsigned long count;
+    char upper_name[32];
+    char define_name[64];
+    int width = (depth_bits > 8) ? 5 : 3;
+    
+    for (count = 0; (table_shape->name[count] != '\0') && (count < sizeof(upper_name) - 1); count++)
+    {
+        upper_name[count] = toupper((unsigned char)table_shape->name[count]);
+    }
+    
+    upper_name[count] = '\0';
+    
+    printf("\n");
+    snprintf(define_name, sizeof(define_name), "%s_%s_SIZE", prefix, upper_name);
+    printf("#define %-32s%lu\n", define_name, size);
+    snprintf(define_name, sizeof(define_name), "%s_%s_QUARTER", prefix, upper_name);
+    printf("#define %-32s%d\n", define_name, is_compressed);
+    printf("\n");
+    printf("static const %s k_%s_%s[%s_%s_SIZE] PROGMEM =\n",
+           (depth_bits > 8) ? "uint16_t" : "uint8_t", table_shape->name, is_curve ? "curve" : "table", prefix, upper_name);
+    printf("{\n");
+    
+    for (count = 0; count < size; count++)
+    {
+        double level = table_shape->function((double)count / (double)span);
+        unsigned long value = (unsigned long)floor((level * maximum) + ROUNDING_OFFSET);
+        
+        if (value > maximum)
+        {
+            value = maximum;
+        }
+        
+        printf("%s%*lu%s", ((count % VALUES_PER_LINE) == 0) ? "    " : " ", width, value,
+               (count + 1 < size) ? "," : "");
+        
+        if ((((count + 1) % VALUES_PER_LINE) == 0) || (count + 1 == size))
+        {
+            printf("\n");
+        }
+    }
+    
+    printf("};\n");
+}
+
+void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-b index_bits] [-d depth_bits] [-f] [-c] shape [shape ...]\n", program);
+    fprintf(stderr, "  -b  Table resolution, %d - %d bits (default %d).\n", MIN_INDEX_BITS, MAX_INDEX_BITS, DEFAULT_INDEX_BITS);
+    fprintf(stderr, "  -d  Amplitude depth, %d - %d bits (default %d).\n", MIN_DEPTH_BITS, MAX_DEPTH_BITS, DEFAULT_DEPTH_BITS);
+    fprintf(stderr, "  -f  Write full tables, no quarter-wave compression.\n");
+    fprintf(stderr, "  -c  Write transfer curves rather than waveforms.\n");
+    fprintf(stderr, "Shapes: sine, triangle, exp, log.\n");
+}